@@ -0,0 +1,168 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace std { namespace experimental {
+
+// A bounded mailbox for an actor: many senders, one receiver (the actor),
+// and a "scheduled" flag that tells senders when to wake the actor.
+//
+// The queue is Dmitry Vyukov's bounded ring, in which each cell carries a
+// sequence number: senders claim a position with one compare-and-swap on
+// the tail and then publish the cell by advancing its sequence number;
+// the receiver needs no atomic read-modify-writes at all.
+//
+// try_send() returns send_result::schedule only when the mailbox goes from
+// idle to having mail; the sender must then hand the actor to its
+// scheduler. Every other successful send returns send_result::sent and
+// does nothing more. When the scheduler runs the actor, it calls
+// drain(), which processes up to a batch of messages and returns whether
+// the actor is still scheduled (there is more mail, so run it again) or
+// has gone idle. Going idle clears the flag and then looks at the queue
+// once more, so mail sent during the drain is never stranded.
+//
+// T must be default-constructible and move-assignable: the cells are
+// pre-filled with T(). The capacity is rounded up to a power of two.
+//
+template<class T>
+class actor_mailbox
+{
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    enum class send_result {
+        full,      // not sent
+        sent,      // sent; the actor is already scheduled
+        schedule,  // sent, and the caller must now schedule the actor
+    };
+
+    explicit actor_mailbox(size_type capacity) :
+        mask_(round_up_(capacity) - 1),
+        cells_(new cell[mask_ + 1]),
+        head_(0),
+        tail_(0),
+        scheduled_(false)
+    {
+        for (size_type i = 0; i <= mask_; ++i) {
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    size_type capacity() const noexcept { return mask_ + 1; }
+
+    // Safe to call from any thread.
+    template<class U>
+    send_result try_send(U&& value)
+    {
+        size_type pos = tail_.load(std::memory_order_relaxed);
+        cell *c;
+        for (;;) {
+            c = &cells_[pos & mask_];
+            const size_type seq = c->seq.load(std::memory_order_acquire);
+            const std::ptrdiff_t dif = std::ptrdiff_t(seq - pos);
+            if (dif == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return send_result::full;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+        c->value = std::forward<U>(value);
+        c->seq.store(pos + 1, std::memory_order_release);
+
+        // Pairs with the fence in drain(): either it sees our message, or
+        // we see that it has cleared the flag.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (scheduled_.load(std::memory_order_relaxed) || scheduled_.exchange(true, std::memory_order_acquire)) {
+            return send_result::sent;
+        }
+        return send_result::schedule;
+    }
+
+    // For the actor: call f(T&&) on up to max_batch messages. Returns true
+    // if the actor is still scheduled and should be run again, false if it
+    // has gone idle (and the next sender will schedule it).
+    template<class F>
+    bool drain(size_type max_batch, F&& f)
+    {
+        assert(scheduled_.load(std::memory_order_relaxed));
+        for (size_type n = 0; n < max_batch && receive_(f); ++n) {
+        }
+        if (not empty_()) {
+            return true;
+        }
+        // Once the flag is clear, a sender may schedule the actor again and
+        // another thread may start draining, so from here on we look only
+        // at the atomic cell, not at head_.
+        const cell& next = cells_[head_ & mask_];
+        const size_type expected = head_ + 1;
+        scheduled_.store(false, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (next.seq.load(std::memory_order_relaxed) != expected) {
+            return false;
+        }
+        // Mail arrived while we were clearing the flag. Its sender may have
+        // seen the flag still set, so take the actor back, unless a later
+        // sender already scheduled it again.
+        return not scheduled_.exchange(true, std::memory_order_acquire);
+    }
+
+    // For the actor: true if there's no mail (that has been completely sent).
+    bool empty() const noexcept { return empty_(); }
+
+private:
+    struct cell {
+        std::atomic<size_type> seq;
+        T value;
+    };
+
+    static size_type round_up_(size_type n) noexcept
+    {
+        size_type p = 1;
+        while (p < n) {
+            p *= 2;
+        }
+        return p;
+    }
+
+    bool empty_() const noexcept
+    {
+        return cells_[head_ & mask_].seq.load(std::memory_order_acquire) != head_ + 1;
+    }
+
+    template<class F>
+    bool receive_(F& f)
+    {
+        cell& c = cells_[head_ & mask_];
+        if (c.seq.load(std::memory_order_acquire) != head_ + 1) {
+            return false;
+        }
+        T value = std::move(c.value);
+        c.seq.store(head_ + mask_ + 1, std::memory_order_release);
+        ++head_;
+        f(std::move(value));
+        return true;
+    }
+
+    // Padded rather than alignas(64): actors are usually heap-allocated,
+    // and C++14's new doesn't honour over-alignment.
+    const size_type mask_;
+    std::unique_ptr<cell[]> cells_;
+    size_type head_;  // receiver-only
+    char pad0_[64];
+    std::atomic<size_type> tail_;
+    char pad1_[64];
+    std::atomic<bool> scheduled_;
+    char pad2_[64];
+};
+
+} } // namespace std::experimental
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "ring_span.h"
+
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace std { namespace experimental {
+
+// Coalesces a producer's items into batches before they go anywhere
+// shared, in the spirit of Nagle's algorithm: instead of touching a shared
+// ring (and waking its consumer) once per item, the producer collects
+// items in a private ring_span and hands them over when either
+// `max_items` have accumulated or the oldest has waited `max_delay`.
+//
+// Handing over means calling sink(batch) with the ring_span of pending
+// items; the sink must take all of them, typically by locking the shared
+// ring once and moving them over with batch.consume_front(batch.size(), f).
+//
+// The delay is only checked when something happens: on push(), and on
+// poll(), which a producer should call when it has nothing to push, so
+// that a lone item doesn't wait for the next one indefinitely. The
+// destructor flushes whatever is left.
+//
+// A batching_producer belongs to one producer thread. It doesn't own its
+// buffer, whose size bounds max_items. It can be moved, e.g. into a
+// container, but not copied.
+//
+template<class T, class Sink, class Clock = std::chrono::steady_clock>
+class batching_producer
+{
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using batch_type = ring_span<T, null_popper<T>>;
+    using duration = typename Clock::duration;
+
+    template<class ContiguousIterator>
+    batching_producer(ContiguousIterator begin, ContiguousIterator end, size_type max_items, duration max_delay, Sink sink = Sink()) :
+        batch_(begin, end, begin, 0),
+        max_items_(max_items),
+        max_delay_(max_delay),
+        sink_(std::move(sink))
+    {
+        assert(max_items != 0 && max_items <= batch_.capacity());
+    }
+
+    // A copy would share the buffer, so producers are move-only. The
+    // moved-from producer is left with no buffer and nothing to flush.
+    batching_producer(batching_producer&& other) noexcept(std::is_nothrow_move_constructible<Sink>::value) :
+        batch_(other.batch_),
+        max_items_(other.max_items_),
+        max_delay_(other.max_delay_),
+        oldest_(other.oldest_),
+        sink_(std::move(other.sink_))
+    {
+        other.batch_ = batch_type();
+    }
+
+    batching_producer& operator=(batching_producer&& other)
+    {
+        if (this != &other) {
+            flush();
+            batch_ = other.batch_;
+            max_items_ = other.max_items_;
+            max_delay_ = other.max_delay_;
+            oldest_ = other.oldest_;
+            sink_ = std::move(other.sink_);
+            other.batch_ = batch_type();
+        }
+        return *this;
+    }
+
+    ~batching_producer()
+    {
+        flush();
+    }
+
+    template<class U>
+    void push(U&& value)
+    {
+        const typename Clock::time_point now = Clock::now();
+        if (batch_.empty()) {
+            oldest_ = now;
+        }
+        batch_.push_back(T(std::forward<U>(value)));
+        if (batch_.size() >= max_items_ || now - oldest_ >= max_delay_) {
+            flush();
+        }
+    }
+
+    // Flush if the oldest pending item has waited max_delay. Returns
+    // whether it flushed.
+    bool poll()
+    {
+        if (batch_.empty() || Clock::now() - oldest_ < max_delay_) {
+            return false;
+        }
+        flush();
+        return true;
+    }
+
+    void flush()
+    {
+        if (not batch_.empty()) {
+            sink_(batch_);
+            assert(batch_.empty());
+        }
+    }
+
+    size_type pending() const noexcept { return batch_.size(); }
+    Sink& sink() noexcept { return sink_; }
+
+private:
+    batch_type batch_;
+    size_type max_items_;
+    duration max_delay_;
+    typename Clock::time_point oldest_;
+    Sink sink_;
+};
+
+} } // namespace std::experimental
@@ -0,0 +1,439 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace std { namespace experimental {
+
+namespace detail {
+
+// A single-producer single-consumer ring of variable-length records.
+// Every record is a header (its padded length and a tag) followed by its
+// bytes, padded to a multiple of the header size, so a header never wraps.
+// A record that wouldn't fit before the end of the buffer is preceded by a
+// padding record running to the end.
+class spsc_record_ring
+{
+public:
+    static constexpr std::uint32_t padding_tag = UINT32_MAX;
+
+    struct header {
+        std::uint32_t length;  // including the header
+        std::uint32_t tag;
+    };
+
+    // capacity is rounded up to a power of two.
+    explicit spsc_record_ring(std::size_t capacity) :
+        capacity_(round_up_(capacity)),
+        data_(new unsigned char[capacity_]),
+        head_(0),
+        tail_(0),
+        cached_tail_(0),
+        pending_(0)
+    {}
+
+    // For the producer: room for a record of `bytes` bytes, or null if
+    // there isn't enough. The record must then be published with commit().
+    unsigned char *reserve(std::uint32_t tag, std::size_t bytes) noexcept
+    {
+        const std::size_t length = padded_(sizeof(header) + bytes);
+        const std::uint64_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t pos = head & (capacity_ - 1);
+        const std::size_t to_end = capacity_ - pos;
+        const std::size_t needed = (length <= to_end) ? length : to_end + length;
+        if (capacity_ - (head - cached_tail_) < needed) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (capacity_ - (head - cached_tail_) < needed) {
+                return nullptr;
+            }
+        }
+        pending_ = head;
+        if (length > to_end) {
+            put_header_(pos, header{std::uint32_t(to_end), padding_tag});
+            pending_ += to_end;
+        }
+        const std::size_t at = pending_ & (capacity_ - 1);
+        put_header_(at, header{std::uint32_t(length), tag});
+        pending_ += length;
+        return data_.get() + at + sizeof(header);
+    }
+
+    void commit() noexcept { head_.store(pending_, std::memory_order_release); }
+
+    // For the consumer: call f(tag, bytes, n) for each record, oldest
+    // first, and free them. Returns how many records there were.
+    template<class F>
+    std::size_t consume(F&& f)
+    {
+        const std::uint64_t head = head_.load(std::memory_order_acquire);
+        std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+        std::size_t records = 0;
+        while (tail != head) {
+            const std::size_t pos = tail & (capacity_ - 1);
+            header h;
+            std::memcpy(&h, data_.get() + pos, sizeof h);
+            if (h.tag != padding_tag) {
+                f(h.tag, data_.get() + pos + sizeof h, std::size_t(h.length - sizeof h));
+                ++records;
+            }
+            tail += h.length;
+        }
+        tail_.store(tail, std::memory_order_release);
+        return records;
+    }
+
+    bool empty() const noexcept
+    {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    std::size_t capacity() const noexcept { return capacity_; }
+
+private:
+    static std::size_t round_up_(std::size_t n) noexcept
+    {
+        std::size_t p = sizeof(header);
+        while (p < n) {
+            p *= 2;
+        }
+        return p;
+    }
+
+    static std::size_t padded_(std::size_t n) noexcept
+    {
+        return (n + sizeof(header) - 1) / sizeof(header) * sizeof(header);
+    }
+
+    void put_header_(std::size_t pos, header h) noexcept { std::memcpy(data_.get() + pos, &h, sizeof h); }
+
+    const std::size_t capacity_;
+    std::unique_ptr<unsigned char[]> data_;
+    // Rings are created with make_unique, and C++14's new ignores
+    // alignas, so padding keeps the producer's and consumer's fields on
+    // separate cache lines.
+    char pad0_[64];
+    std::atomic<std::uint64_t> head_;  // written by the producer
+    char pad1_[64];
+    std::atomic<std::uint64_t> tail_;  // written by the consumer
+    char pad2_[64];
+    std::uint64_t cached_tail_;        // producer-only
+    std::uint64_t pending_;            // producer-only
+    char pad3_[64];
+};
+
+constexpr std::size_t log_args_offset(const std::size_t *sizes, std::size_t i)
+{
+    std::size_t offset = 0;
+    for (std::size_t j = 0; j < i; ++j) {
+        offset += sizes[j];
+    }
+    return offset;
+}
+
+template<class... Args>
+struct log_args {
+    static constexpr std::size_t sizes[sizeof...(Args) + 1] = { sizeof(Args)..., 0 };
+    static constexpr std::size_t bytes = log_args_offset(sizes, sizeof...(Args));
+
+    template<class... Us>
+    static void encode(unsigned char *p, Us&&... us) noexcept
+    {
+        encode_(p, std::index_sequence_for<Args...>(), std::forward<Us>(us)...);
+    }
+
+    // Rebuild the arguments from their bytes and printf them with fmt.
+    static void format(const char *fmt, const unsigned char *p, std::string& out)
+    {
+        format_(fmt, p, out, std::index_sequence_for<Args...>());
+    }
+
+private:
+    template<std::size_t... I, class... Us>
+    static void encode_(unsigned char *p, std::index_sequence<I...>, Us&&... us) noexcept
+    {
+        int expand[] = { 0, (put_<Args>(p + log_args_offset(sizes, I), std::forward<Us>(us)), 0)... };
+        (void)expand;
+        (void)p;  // unused if there are no arguments
+    }
+
+    template<class A, class U>
+    static void put_(unsigned char *p, U&& u) noexcept
+    {
+        const A a(std::forward<U>(u));
+        std::memcpy(p, &a, sizeof a);
+    }
+
+    template<class A>
+    static A get_(const unsigned char *p) noexcept
+    {
+        A a;
+        std::memcpy(&a, p, sizeof a);
+        return a;
+    }
+
+    template<std::size_t... I>
+    static void format_(const char *fmt, const unsigned char *p, std::string& out, std::index_sequence<I...>)
+    {
+        std::tuple<Args...> args(get_<Args>(p + log_args_offset(sizes, I))...);
+        (void)p;
+        (void)args;  // unused if there are no arguments
+        char buf[256];
+        int n = std::snprintf(buf, sizeof buf, fmt, std::get<I>(args)...);
+        if (n < 0) {
+            out.assign(fmt);
+        } else if (std::size_t(n) < sizeof buf) {
+            out.assign(buf, n);
+        } else {
+            out.resize(n + 1);
+            std::snprintf(&out[0], out.size(), fmt, std::get<I>(args)...);
+            out.resize(n);
+        }
+    }
+};
+
+template<class... Args>
+constexpr std::size_t log_args<Args...>::sizes[];
+
+template<class... Args>
+constexpr std::size_t log_args<Args...>::bytes;
+
+} // namespace detail
+
+// A log format registered with a binary_logger: a printf format string
+// taking arguments of types Args.
+template<class... Args>
+struct log_format {
+    std::uint32_t id;
+};
+
+// A logger that defers formatting to a background thread.
+//
+// Formats are registered up front; each gets an id. A log call writes just
+// that id and the raw bytes of its arguments into a ring belonging to the
+// calling thread, so the cost at the call site is a memcpy of the
+// arguments and one release store, with no locks, allocation, or
+// formatting. The exception is a thread's first log call on a given
+// logger, which creates that thread's ring under a lock; a thread can pay
+// that cost up front by calling attach_thread(). A background thread
+// takes records from every thread's ring, rebuilds the arguments, printfs
+// them with the registered format string, and hands the resulting lines
+// to the sink.
+//
+// The arguments must be trivially copyable, and are copied by value: a
+// const char * argument is formatted later, so it must point at
+// something that lives that long, such as a string literal.
+//
+// If a thread's ring is full, log() drops the record and counts it in
+// dropped(), instead of waiting.
+//
+class binary_logger
+{
+public:
+    using sink_type = std::function<void(const std::string&)>;
+
+    explicit binary_logger(sink_type sink, std::size_t ring_bytes = 64 * 1024,
+                           std::chrono::microseconds poll_interval = std::chrono::microseconds(1000)) :
+        sink_(std::move(sink)),
+        ring_bytes_(ring_bytes),
+        poll_interval_(poll_interval),
+        id_(next_id_()++),
+        stop_(false),
+        dropped_(0)
+    {
+        worker_ = std::thread([this] { run_(); });
+    }
+
+    // The worker thread runs on this object, and threads cache its id.
+    binary_logger(const binary_logger&) = delete;
+    binary_logger& operator=(const binary_logger&) = delete;
+
+    // Formats everything already logged before returning.
+    ~binary_logger()
+    {
+        stop_.store(true, std::memory_order_release);
+        worker_.join();
+    }
+
+    template<class... Args>
+    log_format<Args...> add_format(const char *fmt)
+    {
+        static_assert(all_trivially_copyable_<Args...>::value, "log arguments are copied bytewise");
+        std::lock_guard<std::mutex> lk(mutex_);
+        formats_.push_back(format_entry{fmt, &detail::log_args<Args...>::format});
+        return log_format<Args...>{std::uint32_t(formats_.size() - 1)};
+    }
+
+    // Returns false, and counts the record as dropped, if this thread's
+    // ring is full.
+    template<class... Args, class... Us>
+    bool log(const log_format<Args...>& f, Us&&... args)
+    {
+        static_assert(sizeof...(Us) == sizeof...(Args), "wrong number of log arguments");
+        using codec = detail::log_args<Args...>;
+        detail::spsc_record_ring& ring = local_ring_();
+        unsigned char *p = ring.reserve(f.id, codec::bytes);
+        if (p == nullptr) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        codec::encode(p, std::forward<Us>(args)...);
+        ring.commit();
+        return true;
+    }
+
+    // Create the calling thread's ring now, rather than on its first log()
+    // call, which may be on a hot path.
+    void attach_thread()
+    {
+        local_ring_();
+    }
+
+    // Wait until everything logged so far (by any thread) has reached the sink.
+    void flush() const
+    {
+        for (;;) {
+            bool all_empty = true;
+            {
+                std::lock_guard<std::mutex> lk(mutex_);
+                for (auto&& t : threads_) {
+                    all_empty = all_empty && t.ring->empty();
+                }
+            }
+            if (all_empty) {
+                return;
+            }
+            std::this_thread::sleep_for(poll_interval_);
+        }
+    }
+
+    std::uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    template<class... Args>
+    struct all_trivially_copyable_ : std::true_type {};
+
+    template<class A, class... Args>
+    struct all_trivially_copyable_<A, Args...> :
+        std::integral_constant<bool, std::is_trivially_copyable<A>::value && all_trivially_copyable_<Args...>::value> {};
+
+    struct format_entry {
+        const char *fmt;
+        void (*format)(const char *, const unsigned char *, std::string&);
+    };
+
+    struct thread_ring {
+        std::thread::id thread;
+        std::unique_ptr<detail::spsc_record_ring> ring;
+    };
+
+    // Loggers are told apart by id rather than address, in case a new one
+    // is built where an old one was.
+    static std::atomic<std::uint64_t>& next_id_()
+    {
+        static std::atomic<std::uint64_t> id(1);
+        return id;
+    }
+
+    detail::spsc_record_ring& local_ring_()
+    {
+        // One entry per logger this thread has used, most recent first, so
+        // that a thread alternating between a few loggers never has to take
+        // the lock once it has a ring in each. Logger ids are never reused,
+        // so entries for destroyed loggers are just never matched again.
+        struct cache_entry {
+            std::uint64_t logger;
+            detail::spsc_record_ring *ring;
+        };
+        static thread_local std::vector<cache_entry> cache;
+        for (std::size_t i = 0; i < cache.size(); ++i) {
+            if (cache[i].logger == id_) {
+                if (i != 0) {
+                    std::swap(cache[i], cache[0]);
+                }
+                return *cache[0].ring;
+            }
+        }
+        cache.insert(cache.begin(), cache_entry{id_, find_ring_(std::this_thread::get_id())});
+        return *cache[0].ring;
+    }
+
+    detail::spsc_record_ring *find_ring_(std::thread::id thread)
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        for (auto&& t : threads_) {
+            if (t.thread == thread) {
+                return t.ring.get();
+            }
+        }
+        threads_.push_back(thread_ring{thread, std::make_unique<detail::spsc_record_ring>(ring_bytes_)});
+        return threads_.back().ring.get();
+    }
+
+    void run_()
+    {
+        std::vector<detail::spsc_record_ring *> rings;
+        std::vector<format_entry> formats;
+        std::string line;
+        for (;;) {
+            const bool stopping = stop_.load(std::memory_order_acquire);
+            {
+                std::lock_guard<std::mutex> lk(mutex_);
+                rings.clear();
+                for (auto&& t : threads_) {
+                    rings.push_back(t.ring.get());
+                }
+                formats.assign(formats_.begin(), formats_.end());
+            }
+            std::size_t records = 0;
+            for (auto *ring : rings) {
+                records += ring->consume([&](std::uint32_t id, const unsigned char *p, std::size_t) {
+                    if (id >= formats.size()) {
+                        // Registered after we took our copy.
+                        std::lock_guard<std::mutex> lk(mutex_);
+                        formats.assign(formats_.begin(), formats_.end());
+                    }
+                    const format_entry& e = formats[id];
+                    e.format(e.fmt, p, line);
+                    sink_(line);
+                });
+            }
+            if (records == 0) {
+                if (stopping) {
+                    return;
+                }
+                std::this_thread::sleep_for(poll_interval_);
+            }
+        }
+    }
+
+    sink_type sink_;
+    const std::size_t ring_bytes_;
+    const std::chrono::microseconds poll_interval_;
+    const std::uint64_t id_;
+
+    mutable std::mutex mutex_;  // guards threads_ and formats_
+    std::deque<thread_ring> threads_;
+    std::deque<format_entry> formats_;
+
+    std::atomic<bool> stop_;
+    std::atomic<std::uint64_t> dropped_;
+    std::thread worker_;
+};
+
+} } // namespace std::experimental
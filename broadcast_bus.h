@@ -0,0 +1,239 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace std { namespace experimental {
+
+// An in-process publish/subscribe bus: one broadcast ring that every
+// subscriber reads from, instead of a copy of each message per
+// subscriber.
+//
+// Each message carries a topic mask; each subscriber has a cursor into the
+// ring and a filter, and sees the messages whose topics intersect its
+// filter. The ring is split into blocks of BlockSize slots, and each
+// completed block records the union of its messages' topics, so a
+// subscriber skips a whole block of messages it doesn't want after
+// reading one word.
+//
+// The publisher never waits for subscribers: like ring_span::push_back(),
+// publishing into a full ring overwrites the oldest message. Slots and
+// block summaries are seqlocks, so a subscriber that falls more than a
+// ring behind notices that it has been lapped, skips ahead to the oldest
+// message still there, and counts what it missed in dropped(). lag()
+// says how far behind a subscriber is, before it gets that far.
+//
+// T must be trivially copyable. Messages are stored as relaxed atomic
+// words, so reading a slot while it is being overwritten is not a data
+// race. publish() must not be called concurrently (one publisher, or
+// publishers serialized by the caller); any number of subscribers may
+// read concurrently with it and each other, but each subscriber object
+// belongs to one thread.
+//
+template<class T, std::size_t BlockSize = 64>
+class broadcast_bus
+{
+    static_assert(std::is_trivially_copyable<T>::value, "broadcast_bus copies messages bytewise");
+    static_assert(BlockSize != 0, "BlockSize must be positive");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using topic_mask = std::uint64_t;
+
+    class subscriber;
+
+    // capacity is rounded up to a multiple of BlockSize.
+    explicit broadcast_bus(size_type capacity) :
+        capacity_((capacity + BlockSize - 1) / BlockSize * BlockSize),
+        slots_(new slot[capacity_]),
+        blocks_(new block[capacity_ / BlockSize]),
+        head_(0),
+        block_topics_(0)
+    {
+        assert(capacity_ != 0);
+    }
+
+    // Subscribers point back at the bus they read from.
+    broadcast_bus(const broadcast_bus&) = delete;
+    broadcast_bus& operator=(const broadcast_bus&) = delete;
+
+    size_type capacity() const noexcept { return capacity_; }
+
+    // The number of messages ever published.
+    std::uint64_t published() const noexcept { return head_.load(std::memory_order_acquire); }
+
+    void publish(topic_mask topics, const T& value) noexcept
+    {
+        const std::uint64_t pos = head_.load(std::memory_order_relaxed);
+        block& blk = blocks_[(pos / BlockSize) % (capacity_ / BlockSize)];
+        if (pos % BlockSize == 0) {
+            // Starting this block over: its old summary is no longer true.
+            blk.epoch.store(0, std::memory_order_relaxed);
+            block_topics_ = 0;
+        }
+        slot& s = slots_[pos % capacity_];
+        s.seq.store(2 * pos + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::uint64_t words[words_] = {};
+        std::memcpy(words, &value, sizeof(T));
+        s.topics.store(topics, std::memory_order_relaxed);
+        for (size_type i = 0; i < words_; ++i) {
+            s.words[i].store(words[i], std::memory_order_relaxed);
+        }
+        s.seq.store(2 * pos + 2, std::memory_order_release);
+
+        block_topics_ |= topics;
+        if ((pos + 1) % BlockSize == 0) {
+            blk.topics.store(block_topics_, std::memory_order_relaxed);
+            blk.epoch.store(pos / BlockSize + 1, std::memory_order_release);
+        }
+        head_.store(pos + 1, std::memory_order_release);
+    }
+
+    // A subscriber sees messages published after it subscribes.
+    subscriber subscribe(topic_mask filter) const noexcept
+    {
+        return subscriber(this, filter);
+    }
+
+    class subscriber
+    {
+    public:
+        topic_mask filter() const noexcept { return filter_; }
+        void set_filter(topic_mask filter) noexcept { filter_ = filter; }
+
+        // How many messages (of any topic) the publisher is ahead of us.
+        // A lag approaching capacity() means we're about to be lapped.
+        std::uint64_t lag() const noexcept { return bus_->head_.load(std::memory_order_acquire) - cursor_; }
+
+        // How many messages (of any topic) were overwritten before we got to them.
+        std::uint64_t dropped() const noexcept { return dropped_; }
+
+        // Receive the next message matching our filter, if there is one.
+        bool try_receive(T& value, topic_mask *topics = nullptr) noexcept
+        {
+            for (;;) {
+                std::uint64_t head = bus_->head_.load(std::memory_order_acquire);
+                if (cursor_ == head) {
+                    return false;
+                }
+                if (head - cursor_ > bus_->capacity_) {
+                    skip_to_(head - bus_->capacity_);
+                }
+                if (cursor_ % BlockSize == 0 && cursor_ + BlockSize <= head && not block_may_match_()) {
+                    cursor_ += BlockSize;
+                    continue;
+                }
+                topic_mask t;
+                if (not bus_->read_(cursor_, t, value)) {
+                    // Overwritten under us: the publisher is writing
+                    // position (at least) cursor_ + capacity.
+                    head = bus_->head_.load(std::memory_order_acquire);
+                    skip_to_(head + 1 - bus_->capacity_);
+                    continue;
+                }
+                ++cursor_;
+                if (t & filter_) {
+                    if (topics) {
+                        *topics = t;
+                    }
+                    return true;
+                }
+            }
+        }
+
+    private:
+        friend class broadcast_bus;
+
+        subscriber(const broadcast_bus *bus, topic_mask filter) noexcept :
+            bus_(bus),
+            filter_(filter),
+            cursor_(bus->head_.load(std::memory_order_acquire)),
+            dropped_(0)
+        {}
+
+        void skip_to_(std::uint64_t pos) noexcept
+        {
+            if (pos > cursor_) {
+                dropped_ += pos - cursor_;
+                cursor_ = pos;
+            }
+        }
+
+        // False only if the completed block at cursor_ certainly has no
+        // message for us. If it's being overwritten, we can't tell, and
+        // leave it to the slot reads to notice.
+        bool block_may_match_() const noexcept
+        {
+            const std::uint64_t b = cursor_ / BlockSize;
+            const block& blk = bus_->blocks_[b % (bus_->capacity_ / BlockSize)];
+            const std::uint64_t e1 = blk.epoch.load(std::memory_order_acquire);
+            const topic_mask t = blk.topics.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const std::uint64_t e2 = blk.epoch.load(std::memory_order_relaxed);
+            return e1 != b + 1 || e2 != e1 || (t & filter_) != 0;
+        }
+
+        const broadcast_bus *bus_;
+        topic_mask filter_;
+        std::uint64_t cursor_;
+        std::uint64_t dropped_;
+    };
+
+private:
+    static constexpr size_type words_ = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    struct slot {
+        // 2*pos+1 while position pos is being written, 2*pos+2 once it's done.
+        std::atomic<std::uint64_t> seq{0};
+        std::atomic<topic_mask> topics{0};
+        std::atomic<std::uint64_t> words[words_];
+    };
+
+    struct block {
+        // b+1 once block number b is complete and `topics` summarizes it; 0 otherwise.
+        std::atomic<std::uint64_t> epoch{0};
+        std::atomic<topic_mask> topics{0};
+    };
+
+    // Read the message at position pos, which has been published. False
+    // if it has been (or is being) overwritten.
+    bool read_(std::uint64_t pos, topic_mask& topics, T& value) const noexcept
+    {
+        const slot& s = slots_[pos % capacity_];
+        const std::uint64_t s1 = s.seq.load(std::memory_order_acquire);
+        if (s1 != 2 * pos + 2) {
+            assert(s1 > 2 * pos + 2);
+            return false;
+        }
+        std::uint64_t words[words_];
+        topics = s.topics.load(std::memory_order_relaxed);
+        for (size_type i = 0; i < words_; ++i) {
+            words[i] = s.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s.seq.load(std::memory_order_relaxed) != s1) {
+            return false;
+        }
+        std::memcpy(&value, words, sizeof(T));
+        return true;
+    }
+
+    size_type capacity_;
+    std::unique_ptr<slot[]> slots_;
+    std::unique_ptr<block[]> blocks_;
+    std::atomic<std::uint64_t> head_;  // next position to publish
+    topic_mask block_topics_;          // publisher-only: topics so far in the current block
+};
+
+template<class T, std::size_t BlockSize>
+constexpr std::size_t broadcast_bus<T, BlockSize>::words_;
+
+} } // namespace std::experimental
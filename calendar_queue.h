@@ -0,0 +1,272 @@
+#pragma once
+
+#include "ring_span.h"
+#include "trivially_relocatable.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace std { namespace experimental {
+
+namespace detail {
+
+struct calendar_identity {
+    template<class T>
+    const T& operator()(const T& t) const noexcept { return t; }
+};
+
+} // namespace detail
+
+// A calendar queue (R. Brown, CACM 1988): a priority queue for
+// discrete-event simulation with O(1) expected push and pop, offering
+// the same push/top/pop interface as heap_span.
+//
+// Keys (as returned by KeyOf, convertible to double) are dealt into
+// buckets by time, like days on a calendar: an event at time t goes into
+// "day" floor(t / width), which lives in bucket (day % buckets). Each
+// bucket is a small ring_span kept sorted by key, so the earliest event
+// of the bucket is always at its front, and events with equal keys come
+// out in the order they were pushed. pop() walks the days from the
+// current one, and falls back to a direct search of all buckets after
+// a full year of empty days.
+//
+// The number of buckets doubles or halves as the queue grows and shrinks,
+// and each time, the day width is re-estimated as three times the average
+// separation of the earliest events (ignoring outliers).
+//
+// Keys must be non-negative. T must be default-constructible; bucket
+// storage is pre-filled with T().
+// Unlike heap_span, this container owns its storage.
+//
+template<class T, class KeyOf = detail::calendar_identity>
+class calendar_queue
+{
+public:
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+
+    explicit calendar_queue(KeyOf key_of = KeyOf()) :
+        key_of_(std::move(key_of)),
+        width_(1.0),
+        size_(0),
+        day_(0)
+    {
+        buckets_.resize(min_buckets_);
+    }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type buckets() const noexcept { return buckets_.size(); }
+    double bucket_width() const noexcept { return width_; }
+
+    const_reference top() const
+    {
+        return buckets_[locate_()].ring.front();
+    }
+
+    void pop()
+    {
+        assert(not empty());
+        buckets_[locate_()].ring.pop_front();
+        --size_;
+        if (size_ < buckets_.size() / 2 && buckets_.size() > min_buckets_) {
+            resize_(buckets_.size() / 2);
+        }
+    }
+
+    void push(const T& value) { push_(T(value)); }
+    void push(T&& value) { push_(std::move(value)); }
+
+    template<typename... Args>
+    void emplace(Args&&... args) { push_(T(std::forward<Args>(args)...)); }
+
+private:
+    static constexpr size_type min_buckets_ = 2;
+    static constexpr size_type initial_bucket_capacity_ = 4;
+
+    struct bucket {
+        std::vector<T> storage;
+        ring_span<T, null_popper<T>> ring;
+
+        bucket() :
+            storage(initial_bucket_capacity_),
+            ring(storage.begin(), storage.end(), storage.begin(), 0)
+        {}
+
+        // The vector's heap buffer, and so the ring, survives a move.
+        bucket(bucket&&) = default;
+        bucket& operator=(bucket&&) = default;
+    };
+
+    double key_(const T& value) const { return double(key_of_(value)); }
+    std::uint64_t day_of_(double key) const { assert(key >= 0); return std::uint64_t(key / width_); }
+
+    void push_(T&& value)
+    {
+        const std::uint64_t day = day_of_(key_(value));
+        insert_(buckets_[day % buckets_.size()], std::move(value));
+        ++size_;
+        if (day < day_) {
+            // Earlier than anything we were looking at; start over from here.
+            day_ = day;
+        }
+        if (size_ > 2 * buckets_.size()) {
+            resize_(2 * buckets_.size());
+        }
+    }
+
+    void insert_(bucket& b, T&& value)
+    {
+        using std::swap;
+        if (b.ring.full()) {
+            grow_(b);
+        }
+        b.ring.push_back(std::move(value));
+        // Insertion sort from the back: most events land at or near the end.
+        for (size_type i = b.ring.size() - 1; i != 0; --i) {
+            T& prev = detail::element_at(b.ring, i - 1);
+            T& cur = detail::element_at(b.ring, i);
+            if (not (key_(cur) < key_(prev))) {
+                break;
+            }
+            swap(prev, cur);
+        }
+    }
+
+    static void grow_(bucket& b)
+    {
+        std::vector<T> storage(2 * b.storage.size());
+        const size_type n = b.ring.size();
+        T *dest = storage.data();
+        detail::for_each_run(b.ring, 0, n, [&](T *p, size_type len) {
+            move_run_(p, dest, len, std::integral_constant<bool,
+                      is_trivially_relocatable<T>::value && not std::is_trivially_copyable<T>::value>());
+            dest += len;
+        });
+        b.storage.swap(storage);
+        b.ring = ring_span<T, null_popper<T>>(b.storage.begin(), b.storage.end(), b.storage.begin(), n);
+    }
+
+    // Elements that are trivially relocatable but not trivially copyable
+    // (a unique_ptr, say) swap bytewise with the fresh T()s, which is
+    // cheaper than move-assigning them one by one. Trivially copyable ones
+    // are better off with std::move, which is a single memmove, and
+    // anything else is move-assigned.
+    static void move_run_(T *src, T *dest, size_type n, std::true_type)
+    {
+        detail::relocating_swap_ranges(src, dest, n);
+    }
+
+    static void move_run_(T *src, T *dest, size_type n, std::false_type)
+    {
+        std::move(src, src + n, dest);
+    }
+
+    // Find the bucket holding the earliest event, leaving day_ on its day.
+    size_type locate_() const
+    {
+        assert(not empty());
+        const size_type n = buckets_.size();
+        for (size_type i = 0; i < n; ++i, ++day_) {
+            const bucket& b = buckets_[day_ % n];
+            if (not b.ring.empty() && day_of_(key_(b.ring.front())) <= day_) {
+                return day_ % n;
+            }
+        }
+        // A whole year with nothing due: search directly.
+        size_type best = n;
+        for (size_type i = 0; i < n; ++i) {
+            const bucket& b = buckets_[i];
+            if (not b.ring.empty() && (best == n || key_(b.ring.front()) < key_(buckets_[best].ring.front()))) {
+                best = i;
+            }
+        }
+        day_ = day_of_(key_(buckets_[best].ring.front()));
+        return best;
+    }
+
+    // Linear, like the pushes and pops that paid for it: there's no sort.
+    // Events with equal keys share a day, so they sit in one bucket, in
+    // the order they were pushed, and re-inserting that bucket's events in
+    // order keeps it, since insert_() never moves an event past an equal
+    // one. Taking the buckets in day order from day_ means most events
+    // arrive in key order, and the insertion sort seldom has to work.
+    void resize_(size_type new_buckets)
+    {
+        std::vector<T> all;
+        all.reserve(size_);
+        const size_type old_buckets = buckets_.size();
+        for (size_type i = 0; i < old_buckets; ++i) {
+            bucket& b = buckets_[(day_ + i) % old_buckets];
+            detail::for_each_run(b.ring, 0, b.ring.size(), [&](T *p, size_type len) {
+                std::move(p, p + len, std::back_inserter(all));
+            });
+        }
+        width_ = estimate_width_(all);
+        buckets_.clear();
+        buckets_.resize(new_buckets);
+        size_ = 0;
+        day_ = UINT64_MAX;
+        for (auto&& v : all) {
+            const std::uint64_t day = day_of_(key_(v));
+            insert_(buckets_[day % new_buckets], std::move(v));
+            ++size_;
+            day_ = std::min(day_, day);
+        }
+        if (size_ == 0) {
+            day_ = 0;
+        }
+    }
+
+    // Three times the average gap between the earliest few keys, with
+    // unusually large gaps left out of the average.
+    double estimate_width_(const std::vector<T>& all) const
+    {
+        const size_type samples = std::min<size_type>(all.size(), 25);
+        if (samples < 2) {
+            return width_;
+        }
+        std::vector<double> keys;
+        keys.reserve(all.size());
+        for (auto&& v : all) {
+            keys.push_back(key_(v));
+        }
+        std::partial_sort(keys.begin(), keys.begin() + samples, keys.end());
+        const double average = (keys[samples - 1] - keys[0]) / double(samples - 1);
+        double total = 0;
+        size_type count = 0;
+        for (size_type i = 1; i < samples; ++i) {
+            double gap = keys[i] - keys[i - 1];
+            if (gap <= 2 * average) {
+                total += gap;
+                ++count;
+            }
+        }
+        if (count == 0 || total <= 0) {
+            return width_;
+        }
+        return 3 * total / double(count);
+    }
+
+    KeyOf key_of_;
+    std::vector<bucket> buckets_;
+    double width_;
+    size_type size_;
+    mutable std::uint64_t day_;  // the day locate_() is looking at
+};
+
+template<class T, class KeyOf>
+constexpr std::size_t calendar_queue<T, KeyOf>::min_buckets_;
+
+template<class T, class KeyOf>
+constexpr std::size_t calendar_queue<T, KeyOf>::initial_bucket_capacity_;
+
+} } // namespace std::experimental
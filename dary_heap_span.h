@@ -0,0 +1,330 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+namespace std { namespace experimental {
+
+namespace detail {
+
+// Vector helpers for picking the smallest of a node's children.
+// simd_lanes<T> is enabled only for the element types (and instruction sets)
+// we know how to handle; hmin() broadcasts the minimum to every lane.
+
+template<class T> struct simd_lanes {
+    static constexpr bool enabled = false;
+    static constexpr std::size_t width = 1;
+};
+
+#if defined(__AVX2__)
+
+template<> struct simd_lanes<std::int32_t> {
+    static constexpr bool enabled = true;
+    static constexpr std::size_t width = 8;
+    using vec = __m256i;
+    static vec load(const std::int32_t *p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+    static vec min(vec a, vec b) noexcept { return _mm256_min_epi32(a, b); }
+    static vec hmin(vec v) noexcept {
+        v = _mm256_min_epi32(v, _mm256_permute2x128_si256(v, v, 1));
+        v = _mm256_min_epi32(v, _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm256_min_epi32(v, _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+    static unsigned eq_mask(vec a, vec b) noexcept { return unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)))); }
+};
+
+template<> struct simd_lanes<std::uint32_t> {
+    static constexpr bool enabled = true;
+    static constexpr std::size_t width = 8;
+    using vec = __m256i;
+    static vec load(const std::uint32_t *p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+    static vec min(vec a, vec b) noexcept { return _mm256_min_epu32(a, b); }
+    static vec hmin(vec v) noexcept {
+        v = _mm256_min_epu32(v, _mm256_permute2x128_si256(v, v, 1));
+        v = _mm256_min_epu32(v, _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm256_min_epu32(v, _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+    static unsigned eq_mask(vec a, vec b) noexcept { return unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)))); }
+};
+
+template<> struct simd_lanes<float> {
+    static constexpr bool enabled = true;
+    static constexpr std::size_t width = 8;
+    using vec = __m256;
+    static vec load(const float *p) noexcept { return _mm256_loadu_ps(p); }
+    static vec min(vec a, vec b) noexcept { return _mm256_min_ps(a, b); }
+    static vec hmin(vec v) noexcept {
+        v = _mm256_min_ps(v, _mm256_permute2f128_ps(v, v, 1));
+        v = _mm256_min_ps(v, _mm256_permute_ps(v, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm256_min_ps(v, _mm256_permute_ps(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+    static unsigned eq_mask(vec a, vec b) noexcept { return unsigned(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ))); }
+};
+
+#elif defined(__SSE4_1__)
+
+template<> struct simd_lanes<std::int32_t> {
+    static constexpr bool enabled = true;
+    static constexpr std::size_t width = 4;
+    using vec = __m128i;
+    static vec load(const std::int32_t *p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+    static vec min(vec a, vec b) noexcept { return _mm_min_epi32(a, b); }
+    static vec hmin(vec v) noexcept {
+        v = _mm_min_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm_min_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+    static unsigned eq_mask(vec a, vec b) noexcept { return unsigned(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b)))); }
+};
+
+template<> struct simd_lanes<std::uint32_t> {
+    static constexpr bool enabled = true;
+    static constexpr std::size_t width = 4;
+    using vec = __m128i;
+    static vec load(const std::uint32_t *p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+    static vec min(vec a, vec b) noexcept { return _mm_min_epu32(a, b); }
+    static vec hmin(vec v) noexcept {
+        v = _mm_min_epu32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm_min_epu32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+    static unsigned eq_mask(vec a, vec b) noexcept { return unsigned(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b)))); }
+};
+
+template<> struct simd_lanes<float> {
+    static constexpr bool enabled = true;
+    static constexpr std::size_t width = 4;
+    using vec = __m128;
+    static vec load(const float *p) noexcept { return _mm_loadu_ps(p); }
+    static vec min(vec a, vec b) noexcept { return _mm_min_ps(a, b); }
+    static vec hmin(vec v) noexcept {
+        v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+    static unsigned eq_mask(vec a, vec b) noexcept { return unsigned(_mm_movemask_ps(_mm_cmpeq_ps(a, b))); }
+};
+
+#endif
+
+template<class T, std::size_t Arity, class Comparator>
+struct use_simd_min_child : std::integral_constant<bool,
+    simd_lanes<T>::enabled && Arity % simd_lanes<T>::width == 0 &&
+    (std::is_same<Comparator, std::less<>>::value || std::is_same<Comparator, std::less<T>>::value)
+> {};
+
+// Index of the first smallest of p[0..Arity), with one vector min-reduce
+// and one compare+movemask per vector of children.
+template<class T, std::size_t Arity>
+std::size_t simd_min_child(const T *p) noexcept
+{
+    using L = simd_lanes<T>;
+    static_assert(Arity % L::width == 0, "Arity must be a multiple of the vector width");
+    auto m = L::load(p);
+    for (std::size_t k = L::width; k < Arity; k += L::width) {
+        m = L::min(m, L::load(p + k));
+    }
+    m = L::hmin(m);
+    for (std::size_t k = 0; k < Arity; k += L::width) {
+        unsigned mask = L::eq_mask(L::load(p + k), m);
+        if (mask != 0) {
+            return k + unsigned(__builtin_ctz(mask));
+        }
+    }
+    assert(false);
+    return 0;
+}
+
+} // namespace detail
+
+// A d-ary min-heap (by default 8 children per node) over an existing array,
+// with the same interface as heap_span.
+//
+// A wider node means a shallower tree, and all of a node's children share
+// one or two cache lines. For std::int32_t, std::uint32_t and float keys
+// compared with std::less, when built with AVX2 or SSE4.1, the smallest
+// child of a full node is found with vector min and compare+movemask
+// instead of Arity-1 sequential comparisons; everything else (and the
+// last, partially filled node) uses the scalar loop. Float keys must not
+// be NaN.
+//
+template<class T, std::size_t Arity = 8, class Comparator = std::less<>>
+class dary_heap_span
+{
+    static_assert(Arity >= 2, "a heap node needs at least two children");
+
+public:
+    using type = dary_heap_span<T, Arity, Comparator>;
+    using value_type = T;
+    using pointer = T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+
+    static constexpr size_type arity = Arity;
+
+    dary_heap_span() = default;
+
+    template<class ContiguousIterator>
+    dary_heap_span(ContiguousIterator begin, ContiguousIterator end, Comparator cmp = Comparator()) noexcept :
+        data_(&*begin),
+        size_(end - begin),
+        capacity_(end - begin),
+        less_(std::move(cmp))
+    {}
+
+    template<class ContiguousIterator>
+    dary_heap_span(ContiguousIterator begin, ContiguousIterator end, size_type size, Comparator cmp = Comparator()) noexcept :
+        data_(&*begin),
+        size_(size),
+        capacity_(end - begin),
+        less_(std::move(cmp))
+    {}
+
+    reference top() noexcept { return data_[0]; }
+    const_reference top() const noexcept { return data_[0]; }
+
+    bool empty() const noexcept { return size_ == 0; }
+    bool full() const noexcept { return size_ == capacity_; }
+    size_type size() const noexcept { return size_; }
+    size_type capacity() const noexcept { return capacity_; }
+
+    void pop()
+    {
+        assert(not empty());
+        if (size_ == 1) {
+            size_ = 0;
+        } else {
+            data_[0] = std::move(data_[size_ - 1]);
+            --size_;
+            heapify_down_(0);
+        }
+    }
+
+    template<bool b=true, typename=std::enable_if_t<b && std::is_copy_assignable<T>::value>>
+    void push(const T& value) noexcept(std::is_nothrow_copy_assignable<T>::value)
+    {
+        if (full()) {
+            data_[0] = value;
+            heapify_down_(0);
+        } else {
+            data_[size_++] = value;
+            heapify_up_();
+        }
+    }
+
+    template<bool b=true, typename=std::enable_if_t<b && std::is_move_assignable<T>::value>>
+    void push(T&& value) noexcept(std::is_nothrow_move_assignable<T>::value)
+    {
+        if (full()) {
+            data_[0] = std::move(value);
+            heapify_down_(0);
+        } else {
+            data_[size_++] = std::move(value);
+            heapify_up_();
+        }
+    }
+
+    template<typename... Args>
+    void emplace(Args&&... args) noexcept(std::is_nothrow_constructible<T, Args...>::value && std::is_nothrow_move_assignable<T>::value)
+    {
+        push(T(std::forward<Args>(args)...));
+    }
+
+    void make_heap()
+    {
+        if (size_ > 1) {
+            for (size_type i = parent_(size_ - 1) + 1; i-- != 0; ) {
+                heapify_down_(i);
+            }
+        }
+    }
+
+    void swap(dary_heap_span& rhs) noexcept(std::__is_nothrow_swappable<Comparator>::value)
+    {
+        using std::swap;
+        swap(data_, rhs.data_);
+        swap(size_, rhs.size_);
+        swap(capacity_, rhs.capacity_);
+        swap(less_, rhs.less_);
+    }
+
+    friend void swap(dary_heap_span& lhs, dary_heap_span& rhs) noexcept(noexcept(lhs.swap(rhs)))
+    {
+        lhs.swap(rhs);
+    }
+
+private:
+    // all private members are exposition-only
+
+    static size_type parent_(size_type child) { return (child - 1) / Arity; }
+    static size_type first_child_(size_type parent) { return parent * Arity + 1; }
+
+    size_type min_child_(size_type first, size_type count, std::true_type)
+    {
+        if (count == Arity) {
+            return first + detail::simd_min_child<T, Arity>(data_ + first);
+        }
+        return min_child_(first, count, std::false_type());
+    }
+
+    size_type min_child_(size_type first, size_type count, std::false_type)
+    {
+        size_type best = first;
+        for (size_type i = first + 1; i < first + count; ++i) {
+            if (less_(data_[i], data_[best])) {
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    void heapify_up_()
+    {
+        using std::swap;
+        assert(size_ >= 1);
+        size_type idx = size_ - 1;
+        while (idx != 0) {
+            size_type parent = parent_(idx);
+            if (less_(data_[idx], data_[parent])) {
+                swap(data_[idx], data_[parent]);
+                idx = parent;
+            } else {
+                return;
+            }
+        }
+    }
+
+    void heapify_down_(size_type idx)
+    {
+        using std::swap;
+        using simd = detail::use_simd_min_child<T, Arity, Comparator>;
+        while (first_child_(idx) < size_) {
+            const size_type first = first_child_(idx);
+            const size_type count = (size_ - first < Arity) ? (size_ - first) : Arity;
+            const size_type child = min_child_(first, count, simd());
+            if (less_(data_[child], data_[idx])) {
+                swap(data_[idx], data_[child]);
+                idx = child;
+            } else {
+                return;
+            }
+        }
+    }
+
+    T *data_;
+    size_type size_;
+    size_type capacity_;
+    Comparator less_;
+};
+
+template<class T, std::size_t Arity, class Comparator>
+constexpr std::size_t dary_heap_span<T, Arity, Comparator>::arity;
+
+} } // namespace std::experimental
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace std { namespace experimental {
+
+// A single-producer single-consumer queue that grows instead of filling up,
+// without ever stopping either side.
+//
+// Items live in a chain of ring segments. Normally there is just one, and
+// pushing and popping are exactly those of a fixed SPSC ring: a store of
+// the item and a release store of an index, with each side keeping a
+// cached copy of the other's index so it rarely has to load it. When the
+// producer finds its segment full, it allocates one twice the size, puts
+// the item there, and links it after the full one; it never touches the
+// old segment again. The consumer drains the old segment, follows the
+// link, and frees the old segment behind it.
+//
+// Segments only grow, so the queue settles at the size its peak load
+// needed. T must be default-constructible and move-assignable: segments
+// are pre-filled with T().
+//
+template<class T>
+class elastic_spsc_queue
+{
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    // initial_capacity is rounded up to a power of two.
+    explicit elastic_spsc_queue(size_type initial_capacity = 64) :
+        head_seg_(new segment(round_up_(initial_capacity))),
+        tail_seg_(head_seg_),
+        segments_(1)
+    {}
+
+    // The queue owns its segments through raw pointers.
+    elastic_spsc_queue(const elastic_spsc_queue&) = delete;
+    elastic_spsc_queue& operator=(const elastic_spsc_queue&) = delete;
+
+    ~elastic_spsc_queue()
+    {
+        for (segment *s = head_seg_; s != nullptr; ) {
+            segment *next = s->next.load(std::memory_order_relaxed);
+            delete s;
+            s = next;
+        }
+    }
+
+    // For the producer.
+    template<class U>
+    void push(U&& value)
+    {
+        segment *s = tail_seg_;
+        const std::uint64_t tail = s->tail.load(std::memory_order_relaxed);
+        if (tail - s->cached_head == s->mask + 1) {
+            s->cached_head = s->head.load(std::memory_order_acquire);
+            if (tail - s->cached_head == s->mask + 1) {
+                grow_(std::forward<U>(value));
+                return;
+            }
+        }
+        s->data[tail & s->mask] = std::forward<U>(value);
+        s->tail.store(tail + 1, std::memory_order_release);
+    }
+
+    // For the consumer.
+    bool try_pop(T& value)
+    {
+        for (;;) {
+            segment *s = head_seg_;
+            const std::uint64_t head = s->head.load(std::memory_order_relaxed);
+            if (head == s->cached_tail) {
+                s->cached_tail = s->tail.load(std::memory_order_acquire);
+            }
+            if (head != s->cached_tail) {
+                value = std::move(s->data[head & s->mask]);
+                s->head.store(head + 1, std::memory_order_release);
+                return true;
+            }
+            segment *next = s->next.load(std::memory_order_acquire);
+            if (next == nullptr) {
+                return false;
+            }
+            // The producer finished with s before linking next, but may
+            // have pushed into s after we last looked.
+            s->cached_tail = s->tail.load(std::memory_order_acquire);
+            if (head != s->cached_tail) {
+                continue;
+            }
+            head_seg_ = next;
+            segments_.fetch_sub(1, std::memory_order_relaxed);
+            delete s;
+        }
+    }
+
+    // For the producer: the capacity of the segment it is filling.
+    size_type capacity() const noexcept { return tail_seg_->mask + 1; }
+
+    // How many segments are allocated (from either side, approximately).
+    size_type segments() const noexcept { return segments_.load(std::memory_order_relaxed); }
+
+private:
+    struct segment {
+        explicit segment(size_type capacity) :
+            data(new T[capacity]),
+            mask(capacity - 1),
+            head(0),
+            cached_tail(0),
+            tail(0),
+            cached_head(0),
+            next(nullptr)
+        {}
+
+        // Segments are allocated with plain new, which in C++14 doesn't
+        // honour alignas, so the two sides' fields are kept a cache line
+        // apart by padding instead.
+        const std::unique_ptr<T[]> data;
+        const size_type mask;
+        char pad0_[64];
+        std::atomic<std::uint64_t> head;  // written by the consumer
+        std::uint64_t cached_tail;        // consumer-only
+        char pad1_[64];
+        std::atomic<std::uint64_t> tail;  // written by the producer
+        std::uint64_t cached_head;        // producer-only
+        std::atomic<segment *> next;      // written once, by the producer
+        char pad2_[64];
+    };
+
+    static size_type round_up_(size_type n) noexcept
+    {
+        size_type p = 1;
+        while (p < n) {
+            p *= 2;
+        }
+        return p;
+    }
+
+    template<class U>
+    void grow_(U&& value)
+    {
+        segment *s = new segment(2 * (tail_seg_->mask + 1));
+        s->data[0] = std::forward<U>(value);
+        s->tail.store(1, std::memory_order_relaxed);
+        segments_.fetch_add(1, std::memory_order_relaxed);
+        tail_seg_->next.store(s, std::memory_order_release);
+        tail_seg_ = s;
+    }
+
+    segment *head_seg_;  // consumer-only
+    char pad_[64];
+    segment *tail_seg_;  // producer-only
+    std::atomic<size_type> segments_;
+};
+
+} } // namespace std::experimental
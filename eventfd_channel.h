@@ -0,0 +1,171 @@
+#pragma once
+
+// Linux only: uses eventfd(2).
+
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <utility>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace std { namespace experimental {
+
+// A single-producer single-consumer ring whose consumer can wait for it in
+// an event loop: fd() is an eventfd that becomes readable when the ring
+// goes from empty to non-empty, so it can sit in an epoll set (or poll or
+// select) alongside sockets.
+//
+// To keep system calls rare, the producer writes to the eventfd only when
+// the consumer is "armed", i.e. has said it's about to wait, and the first
+// push after that disarms it; every other push is just a ring store. The
+// consumer drains the ring and then calls rearm(), which clears the
+// eventfd and arms again, but returns false if items arrived in the
+// meantime, in which case the consumer should keep draining instead of
+// waiting:
+//
+//     for (;;) {
+//         epoll_wait(...);                   // ch.fd() is in the set
+//         do {
+//             while (ch.try_pop(item)) { ... }
+//         } while (not ch.rearm());
+//     }
+//
+// A channel starts out armed. signals() and clears() count the eventfd
+// writes and reads, which are the only system calls it makes. A wakeup
+// can occasionally be spurious (the ring already drained), but each
+// signal causes at most two.
+//
+// Like ring_span, the channel doesn't own its buffer; T must be
+// move-assignable. Unlike ring_span::push_back(), try_push() refuses to
+// overwrite when the ring is full.
+//
+template<class T>
+class eventfd_channel
+{
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    template<class ContiguousIterator>
+    eventfd_channel(ContiguousIterator begin, ContiguousIterator end) :
+        data_(&*begin),
+        capacity_(end - begin),
+        fd_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+        head_(0),
+        tail_(0),
+        armed_(true),
+        signals_(0),
+        cleared_(0),
+        clears_(0)
+    {
+        assert(capacity_ != 0);
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::system_category(), "eventfd");
+        }
+    }
+
+    // The channel owns its eventfd, which the event loop has registered.
+    eventfd_channel(const eventfd_channel&) = delete;
+    eventfd_channel& operator=(const eventfd_channel&) = delete;
+
+    ~eventfd_channel()
+    {
+        ::close(fd_);
+    }
+
+    int fd() const noexcept { return fd_; }
+    size_type capacity() const noexcept { return capacity_; }
+
+    // For the producer. Returns false if the ring is full.
+    template<class U>
+    bool try_push(U&& value)
+    {
+        const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == capacity_) {
+            return false;
+        }
+        data_[tail % capacity_] = std::forward<U>(value);
+        tail_.store(tail + 1, std::memory_order_release);
+
+        // Pairs with the fence in rearm(): either the consumer sees our
+        // item, or we see that it has armed.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (armed_.load(std::memory_order_relaxed) && armed_.exchange(false, std::memory_order_relaxed)) {
+            // Count the signal first, so that the consumer never finds the
+            // eventfd readable without knowing it needs a read() to clear
+            // it; it may instead try a read() too early, which is harmless.
+            signals_.fetch_add(1, std::memory_order_relaxed);
+            const std::uint64_t one = 1;
+            ssize_t n = ::write(fd_, &one, sizeof one);
+            (void)n;  // can only fail if the counter would overflow, and then it's readable anyway
+        }
+        return true;
+    }
+
+    // For the consumer.
+    bool try_pop(T& value)
+    {
+        const std::uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(data_[head % capacity_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // For the consumer, once it has drained the ring: clear the eventfd and
+    // arm it for the next push. Returns true if the ring is still empty,
+    // so it's safe to wait on fd(); false if something arrived meanwhile.
+    bool rearm()
+    {
+        if (cleared_ != signals_.load(std::memory_order_relaxed)) {
+            std::uint64_t count;
+            if (::read(fd_, &count, sizeof count) == sizeof count) {
+                cleared_ += count;
+            }
+            ++clears_;
+        }
+        armed_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (head_.load(std::memory_order_relaxed) != tail_.load(std::memory_order_relaxed)) {
+            // We're going to keep draining, so spare the producer the
+            // write(), unless it has already taken the flag.
+            armed_.store(false, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    bool empty() const noexcept
+    {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    std::uint64_t signals() const noexcept { return signals_.load(std::memory_order_relaxed); }
+    std::uint64_t clears() const noexcept { return clears_; }
+
+private:
+    T *data_;
+    size_type capacity_;
+    int fd_;
+    // A channel may well live on the heap, where C++14 ignores alignas,
+    // so the hot fields are kept apart with padding.
+    char pad0_[64];
+    std::atomic<std::uint64_t> head_;  // written by the consumer
+    char pad1_[64];
+    std::atomic<std::uint64_t> tail_;  // written by the producer
+    char pad2_[64];
+    std::atomic<bool> armed_;
+    std::atomic<std::uint64_t> signals_;
+    std::uint64_t cleared_;  // consumer-only: signals read back from the eventfd
+    std::uint64_t clears_;   // consumer-only: reads of the eventfd
+    char pad3_[64];
+};
+
+} } // namespace std::experimental
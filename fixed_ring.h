@@ -1,12 +1,30 @@
 #pragma once
 
-#include "ring_view.h"
+#include "trivially_relocatable.h"
+
 #include <array>
+#include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
 
 // An implementation of fixed_ring<T,N> as specified in Guy Davidson's
 // P0059R0 "A proposal to add a ring adaptor to the standard library".
 //
+// A fixed_ring holds nothing but its container and two indices; in
+// particular, no pointers into itself. So copying and moving are the
+// implicit member-wise ones, and a fixed_ring over a trivially copyable
+// T (in a std::array) is itself trivially copyable: it can live in shared
+// memory, or be copied with memcpy.
+//
+// Moves stay member-wise even when T is trivially relocatable. Every slot
+// of the container holds a live T, so a bytewise move would still have to
+// put each source slot back into a valid state, which costs about as much
+// as moving it, and declaring the move members would stop a fixed_ring of
+// a trivially copyable T being trivially copyable. swap() is different:
+// it leaves every slot on both sides valid, so it goes bytewise.
+//
 template<class T, std::size_t Capacity, class Container = std::array<T, Capacity>>
 class fixed_ring
 {
@@ -31,85 +49,102 @@ public:
     fixed_ring() noexcept(std::is_nothrow_default_constructible<Container>::value) :
         // TODO: proposal says is_nothrow_default_constructible<T>
         ctr_(),
-        rv_(ctr_.begin(), ctr_.end(), ctr_.begin(), 0)
-    {}
-
-    // TODO: this should probably be disabled if T isn't copy-constructible
-    fixed_ring(const fixed_ring& rhs) noexcept(std::is_nothrow_copy_constructible<Container>::value) :
-        fixed_ring(&*rhs.rv_.begin() - rhs.ctr_.begin(), rhs.rv_.size(), rhs.ctr_)
-    {}
-
-    // TODO: this should probably be disabled if T isn't move-constructible
-    // TODO: this move-constructs a whole new std::array, an expensive default behavior IMHO
-    fixed_ring(fixed_ring&& rhs) noexcept(std::is_nothrow_move_constructible<Container>::value) :
-        fixed_ring(&*rhs.rv_.begin() - rhs.ctr_.begin(), rhs.rv_.size(), std::move(rhs.ctr_))
+        front_(0),
+        size_(0)
     {}
 
     fixed_ring(const container_type& rhs) noexcept(std::is_nothrow_copy_constructible<Container>::value) :
-        fixed_ring(0, rhs.size(), rhs)
+        ctr_(rhs),
+        front_(0),
+        size_(index_type(rhs.size()))
     {}
 
     fixed_ring(container_type&& rhs) noexcept(std::is_nothrow_move_constructible<Container>::value) :
-        fixed_ring(0, rhs.size(), std::move(rhs))
+        ctr_(std::move(rhs)),
+        front_(0),
+        size_(index_type(ctr_.size()))
     {}
 
-    fixed_ring& operator=(const fixed_ring& rhs) noexcept(std::is_nothrow_copy_assignable<Container>::value)
-    {
-        ctr_ = rhs.ctr_;
-        auto first_idx = (&*rhs.rv_.begin() - rhs.ctr_.begin());
-        rv_ = ring_view<T>(ctr_.begin(), ctr_.end(), ctr_.begin() + first_idx, rhs.rv_.size());
-        return *this;
-    }
-
-    fixed_ring& operator=(fixed_ring&& rhs) noexcept(std::is_nothrow_copy_assignable<Container>::value)
-    {
-        auto first_idx = (&*rhs.rv_.begin() - rhs.ctr_.begin());
-        ctr_ = std::move(rhs.ctr_);
-        rv_ = ring_view<T>(ctr_.begin(), ctr_.end(), ctr_.begin() + first_idx, rhs.rv_.size());
-        return *this;
-    }
-
-    void push(const value_type& v) { rv_.push_back(v); }
-    void push(value_type&& v) { rv_.push_back(std::move(v)); }
+    void push(const value_type& v) { push_back_() = v; }
+    void push(value_type&& v) { push_back_() = std::move(v); }
 
     template<class... Args> bool emplace(Args&&... args)
     {
-        rv_.push(T(std::forward<Args>(args)...));
+        push_back_() = T(std::forward<Args>(args)...);
         return true;  // TODO: what are the semantics of this return value?
     }
 
-    bool try_push(const value_type& v) { return rv_.full() ? false : (rv_.push_back(v), true); }
-    bool try_push(value_type&& v) { return rv_.full() ? false : (rv_.push_back(std::move(v)), true); }
+    bool try_push(const value_type& v) { return full_() ? false : (push(v), true); }
+    bool try_push(value_type&& v) { return full_() ? false : (push(std::move(v)), true); }
 
     template<class... Args>
-    bool try_emplace(Args&&... args) { return rv_.full() ? false : (rv_.push_back(T(std::forward<Args>(args)...)), true); }
+    bool try_emplace(Args&&... args) { return full_() ? false : (emplace(std::forward<Args>(args)...), true); }
+
+    void pop() noexcept
+    {
+        assert(not empty());
+        // Like ring_span's move_popper, move the element out (and drop it).
+        (void)value_type(std::move(ctr_[front_]));
+        front_ = index_type((size_type(front_) + 1) % Capacity);
+        --size_;
+    }
 
-    void pop() noexcept { rv_.pop_front(); }
-    bool empty() const noexcept { return rv_.empty(); }
-    size_type size() const noexcept { return rv_.size(); }
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
 
     // TODO: the proposal doesn't mention this member function
     constexpr size_type capacity() const noexcept { return Capacity; }
 
-    reference front() noexcept { return rv_.front(); }
-    const_reference front() const noexcept { return rv_.front(); }
-    reference back() noexcept { return rv_.back(); }
-    const_reference back() const noexcept { return rv_.back(); }
+    reference front() noexcept { return ctr_[front_]; }
+    const_reference front() const noexcept { return ctr_[front_]; }
+    reference back() noexcept { return ctr_[back_idx_()]; }
+    const_reference back() const noexcept { return ctr_[back_idx_()]; }
 
     void swap(fixed_ring& rhs) noexcept
     {
         using std::swap;
-        swap(ctr_, rhs.ctr_);
-        swap(rv_, rhs.rv_);
+        swap_ctr_(rhs, std::is_same<Container, std::array<T, Capacity>>());
+        swap(front_, rhs.front_);
+        swap(size_, rhs.size_);
     }
 
 private:
-    template<class... Args>
-    fixed_ring(size_type first_idx, size_type size, Args&&... args) noexcept(Container(std::forward<Args>(args)...)) :
-        ctr_(std::forward<Args>(args)...),
-        rv_(ctr_.begin(), ctr_.end(), ctr_.begin() + first_idx, size)
-    {}
+    // The smallest unsigned type that can count up to Capacity. Storing
+    // indices rather than a ring_view (a pointer and three size_ts) keeps
+    // the overhead of e.g. a fixed_ring<uint8_t, 16> down to two bytes.
+    using index_type = std::conditional_t<(Capacity <= UINT8_MAX), std::uint8_t,
+                       std::conditional_t<(Capacity <= UINT16_MAX), std::uint16_t,
+                       std::conditional_t<(Capacity <= UINT32_MAX), std::uint32_t, std::size_t>>>;
+
+    // Two std::arrays of trivially relocatable elements swap bytewise.
+    void swap_ctr_(fixed_ring& rhs, std::true_type) noexcept
+    {
+        std::experimental::detail::relocating_swap_ranges(ctr_.data(), rhs.ctr_.data(), Capacity);
+    }
+
+    void swap_ctr_(fixed_ring& rhs, std::false_type) noexcept
+    {
+        using std::swap;
+        swap(ctr_, rhs.ctr_);
+    }
+
+    bool full_() const noexcept { return size_ == Capacity; }
+    size_type back_idx_() const noexcept { return (size_type(front_) + size_ - 1) % Capacity; }
+
+    // Make room for one more element at the back, forgetting the front
+    // element if we're full, and return the slot.
+    reference push_back_() noexcept
+    {
+        if (full_()) {
+            reference slot = ctr_[front_];
+            front_ = index_type((size_type(front_) + 1) % Capacity);
+            return slot;
+        }
+        ++size_;
+        return ctr_[back_idx_()];
+    }
 
     Container ctr_;
-    ring_view<T> rv_;
+    index_type front_;
+    index_type size_;
 };
@@ -4,8 +4,11 @@
 #include <cassert>
 #include <cstddef>
 #include <functional>
+#include <future>
+#include <thread>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace std { namespace experimental {
 
@@ -31,10 +34,11 @@ public:
     {}
 
     template<class ContiguousIterator>
-    heap_span(ContiguousIterator begin, ContiguousIterator end, size_type size) noexcept :
+    heap_span(ContiguousIterator begin, ContiguousIterator end, size_type size, Comparator cmp = Comparator()) noexcept :
         data_(&*begin),
         size_(size),
-        capacity_(end - begin)
+        capacity_(end - begin),
+        less_(std::move(cmp))
     {}
 
     reference top() noexcept { return data_[0]; }
@@ -51,21 +55,18 @@ public:
         if (size_ == 1) {
             size_ = 0;
         } else {
-            data_[0] = std::move(data_[size_ - 1]);
             --size_;
-            heapify_down_();
+            sift_down_(0, std::move(data_[size_]));
         }
     }
 
     template<bool b=true, typename=std::enable_if_t<b && std::is_copy_assignable<T>::value>>
-    void push(const T& value) noexcept(std::is_nothrow_copy_assignable<T>::value)
+    void push(const T& value) noexcept(std::is_nothrow_copy_assignable<T>::value && std::is_nothrow_move_assignable<T>::value)
     {
         if (full()) {
-            data_[0] = value;
-            heapify_down_();
+            sift_down_(0, value);
         } else {
-            data_[size_++] = value;
-            heapify_up_();
+            sift_up_(size_++, value);
         }
     }
 
@@ -73,23 +74,20 @@ public:
     void push(T&& value) noexcept(std::is_nothrow_move_assignable<T>::value)
     {
         if (full()) {
-            data_[0] = std::move(value);
-            heapify_down_();
+            sift_down_(0, std::move(value));
         } else {
-            data_[size_++] = std::move(value);
-            heapify_up_();
+            sift_up_(size_++, std::move(value));
         }
     }
 
     template<typename... Args>
     void emplace(Args&&... args) noexcept(std::is_nothrow_constructible<T, Args...>::value && std::is_nothrow_move_assignable<T>::value)
     {
+        T value(std::forward<Args>(args)...);
         if (full()) {
-            data_[0] = T(std::forward<Args>(args)...);
-            heapify_down_();
+            sift_down_(0, std::move(value));
         } else {
-            data_[size_++] = T(std::forward<Args>(args)...);
-            heapify_up_();
+            sift_up_(size_++, std::move(value));
         }
     }
 
@@ -99,11 +97,70 @@ public:
         std::sort(data_, data_ + size_, less_);
     }
 
+    // Sort `nthreads` slices concurrently, then merge them pairwise,
+    // also concurrently. `nthreads == 0` means hardware_concurrency().
+    void sort(unsigned nthreads)
+    {
+        nthreads = parallel_threads_(nthreads);
+        if (nthreads <= 1) {
+            sort();
+            return;
+        }
+        std::vector<size_type> bounds;
+        for (unsigned i = 0; i <= nthreads; ++i) {
+            bounds.push_back(size_ * i / nthreads);
+        }
+        parallel_for_(nthreads, [&](unsigned i) {
+            std::sort(data_ + bounds[i], data_ + bounds[i + 1], less_);
+        });
+        while (bounds.size() > 2) {
+            const unsigned merges = unsigned(bounds.size() - 1) / 2;
+            parallel_for_(merges, [&](unsigned i) {
+                std::inplace_merge(data_ + bounds[2*i], data_ + bounds[2*i + 1], data_ + bounds[2*i + 2], less_);
+            });
+            std::vector<size_type> merged;
+            for (size_type i = 0; i < bounds.size(); i += 2) {
+                merged.push_back(bounds[i]);
+            }
+            if (merged.back() != bounds.back()) {
+                merged.push_back(bounds.back());
+            }
+            bounds.swap(merged);
+        }
+    }
+
     void make_heap()
     {
         heapify_();
     }
 
+    // Build the heap bottom-up with the subtrees below a certain depth
+    // heapified concurrently, then finish the few nodes above them on
+    // the calling thread. `nthreads == 0` means hardware_concurrency().
+    void make_heap(unsigned nthreads)
+    {
+        nthreads = parallel_threads_(nthreads);
+        if (nthreads <= 1) {
+            heapify_();
+            return;
+        }
+        // Aim for several subtrees per thread to even out the load.
+        size_type depth = 0;
+        while ((size_type(1) << depth) < size_type(nthreads) * 4) {
+            ++depth;
+        }
+        const size_type first_root = (size_type(1) << depth) - 1;
+        const size_type roots = size_type(1) << depth;
+        parallel_for_(nthreads, [&](unsigned t) {
+            for (size_type r = first_root + roots * t / nthreads; r < first_root + roots * (t + 1) / nthreads; ++r) {
+                heapify_subtree_(r);
+            }
+        });
+        for (size_type i = first_root; i-- != 0; ) {
+            heapify_down_(i);
+        }
+    }
+
     void swap(heap_span& rhs) noexcept(std::__is_nothrow_swappable<Comparator>::value)
     {
         using std::swap;
@@ -127,57 +184,119 @@ private:
 
     void heapify_()
     {
-        const size_type final_size = size_;
-        size_ = 0;
-        while (size_ != final_size) {
-            ++size_;
-            heapify_up_();
+        for (size_type i = size_ / 2; i-- != 0; ) {
+            heapify_down_(i);
         }
     }
 
-    void heapify_up_()
+    // Floyd's bottom-up heapify, restricted to the subtree rooted at `root`.
+    void heapify_subtree_(size_type root)
+    {
+        if (root >= size_ / 2) {
+            return;
+        }
+        // Find the deepest level of the subtree that has any children,
+        // then work upwards level by level.
+        size_type first = root;
+        size_type width = 1;
+        while (left_child_(first) < size_ / 2) {
+            first = left_child_(first);
+            width *= 2;
+        }
+        for (;;) {
+            for (size_type i = first + width; i-- != first; ) {
+                if (i < size_ / 2) {
+                    heapify_down_(i);
+                }
+            }
+            if (first == root) {
+                return;
+            }
+            first = parent_(first);
+            width /= 2;
+        }
+    }
+
+    unsigned parallel_threads_(unsigned nthreads) const
+    {
+        if (nthreads == 0) {
+            nthreads = std::thread::hardware_concurrency();
+        }
+        // Below this many elements per thread, threads cost more than they save.
+        const size_type grain = 16384;
+        if (size_ / grain < nthreads) {
+            nthreads = unsigned(size_ / grain);
+        }
+        return nthreads;
+    }
+
+    template<class F>
+    static void parallel_for_(unsigned n, F&& f)
+    {
+        std::vector<std::future<void>> futures;
+        futures.reserve(n);
+        for (unsigned i = 1; i < n; ++i) {
+            futures.push_back(std::async(std::launch::async, [&f, i]() { f(i); }));
+        }
+        f(0u);
+        for (auto&& fut : futures) {
+            fut.get();
+        }
+    }
+
+    // Rather than swapping the moving element with its parent or child at
+    // every level (three moves each), shift each displaced element into a
+    // hole with one move, and assign the new element once, at the end.
+    // push() and pop() pass their element straight in, since it lives
+    // outside the holes; heapify_down_() has to lift data_[idx] out into a
+    // temporary first.
+
+    void heapify_down_(size_type idx)
+    {
+        T value(std::move(data_[idx]));
+        sift_down_(idx, std::move(value));
+    }
+
+    // Place `value` into the hole at `idx`, moving it up as needed.
+    template<class U>
+    void sift_up_(size_type idx, U&& value)
     {
-        using std::swap;
-        assert(size_ >= 1);
-        size_type idx = size_ - 1;
         while (idx != 0) {
             size_type parent = parent_(idx);
-            if (less_(data_[idx], data_[parent])) {
-                swap(data_[idx], data_[parent]);
-                idx = parent;
-            } else {
-                return;
+            if (not less_(value, data_[parent])) {
+                break;
             }
+            data_[idx] = std::move(data_[parent]);
+            idx = parent;
         }
+        data_[idx] = std::forward<U>(value);
     }
 
-    void heapify_down_()
+    // Place `value` into the hole at `idx`, moving it down as needed.
+    template<class U>
+    void sift_down_(size_type idx, U&& value)
     {
-        using std::swap;
-        size_type idx = 0;
+        // Pick the smaller child by adding the comparison result to the
+        // left child's index, rather than branching on it; on random data
+        // that branch is a coin flip. The remaining branch, whether to keep
+        // sinking, is almost always taken.
         while (right_child_(idx) < size_) {
             size_type left = left_child_(idx);
-            size_type right = right_child_(idx);
-            if (less_(data_[left], data_[idx])) {
-                if (less_(data_[right], data_[left])) {
-                    swap(data_[idx], data_[right]);
-                    idx = right;
-                } else {
-                    swap(data_[idx], data_[left]);
-                    idx = left;
-                }
-            } else if (less_(data_[right], data_[idx])) {
-                swap(data_[idx], data_[right]);
-                idx = right;
-            } else {
-                return;
+            size_type child = left + size_type(less_(data_[left + 1], data_[left]));
+            if (not less_(data_[child], value)) {
+                break;
             }
+            data_[idx] = std::move(data_[child]);
+            idx = child;
         }
         if (left_child_(idx) < size_) {
-            if (less_(data_[left_child_(idx)], data_[idx])) {
-                swap(data_[idx], data_[left_child_(idx)]);
+            size_type left = left_child_(idx);
+            if (less_(data_[left], value)) {
+                data_[idx] = std::move(data_[left]);
+                idx = left;
             }
         }
+        data_[idx] = std::forward<U>(value);
     }
 
     T *data_;
@@ -0,0 +1,284 @@
+#pragma once
+
+#include "ring_span.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace std { namespace experimental {
+
+// Frequent items over the last `window` pushed keys.
+//
+// Every key in the window is kept in a ring_span. push() increments the
+// count of the new key and decrements the count of the key that falls out
+// of the window, and the counters are kept in an indexed binary heap so
+// that each update costs O(log n).
+//
+// With `counters == 0` the counts are exact: every distinct key in the
+// window has a counter, the heap is ordered by largest count, and
+// top_k(k) walks only the top of the heap in O(k log k).
+//
+// With `counters > 0` memory is bounded using the Space-Saving algorithm:
+// when a new key arrives and all counters are in use, the counter with the
+// smallest count is reassigned to it (so the heap is ordered by smallest
+// count), and its old count is remembered as the new key's overestimation
+// error. When an untracked key leaves the window, the smallest counter gives
+// back one occurrence, so the counts always sum to the window size and no
+// count overestimates by more than window/counters. top_k() sorts the
+// counters.
+//
+template<class Key, class Hash = std::hash<Key>>
+class window_heavy_hitters
+{
+public:
+    using key_type = Key;
+    using size_type = std::size_t;
+
+    struct item {
+        Key key;
+        size_type count;
+        size_type error;  // overestimation inherited from a reassigned counter
+    };
+
+    explicit window_heavy_hitters(size_type window, size_type counters = 0) :
+        window_buffer_(window),
+        window_(window_buffer_.begin(), window_buffer_.end(), window_buffer_.begin(), 0),
+        max_counters_(counters)
+    {
+        assert(window != 0);
+        if (bounded_()) {
+            counters_.reserve(counters);
+            heap_.reserve(counters);
+            index_.reserve(counters);
+        }
+    }
+
+    // window_ is a view of window_buffer_; a copy would still look at ours.
+    window_heavy_hitters(const window_heavy_hitters&) = delete;
+    window_heavy_hitters& operator=(const window_heavy_hitters&) = delete;
+
+    void push(const Key& k)
+    {
+        if (window_.full()) {
+            decrement_(window_.front());
+        }
+        window_.push_back(k);
+        increment_(k);
+    }
+
+    size_type window_size() const noexcept { return window_.size(); }
+    size_type tracked() const noexcept { return heap_.size(); }
+
+    size_type count(const Key& k) const
+    {
+        auto it = index_.find(k);
+        return (it == index_.end()) ? 0 : counters_[it->second].count;
+    }
+
+    // The (at most) k keys with the largest counts, largest first.
+    std::vector<item> top_k(size_type k) const
+    {
+        std::vector<item> result;
+        k = std::min(k, heap_.size());
+        result.reserve(k);
+        if (k == 0) {
+            return result;
+        }
+        if (bounded_()) {
+            std::vector<size_type> ids(heap_);
+            std::partial_sort(ids.begin(), ids.begin() + k, ids.end(), [&](size_type a, size_type b) {
+                return counters_[a].count > counters_[b].count;
+            });
+            for (size_type i = 0; i < k; ++i) {
+                result.push_back(to_item_(ids[i]));
+            }
+        } else {
+            // The heap is ordered largest-first; explore it best-first.
+            auto smaller = [&](size_type a, size_type b) {
+                return counters_[heap_[a]].count < counters_[heap_[b]].count;
+            };
+            std::vector<size_type> frontier;
+            frontier.reserve(2 * k);
+            frontier.push_back(0);
+            while (result.size() != k) {
+                std::pop_heap(frontier.begin(), frontier.end(), smaller);
+                size_type pos = frontier.back();
+                frontier.pop_back();
+                result.push_back(to_item_(heap_[pos]));
+                for (size_type child : { left_child_(pos), right_child_(pos) }) {
+                    if (child < heap_.size()) {
+                        frontier.push_back(child);
+                        std::push_heap(frontier.begin(), frontier.end(), smaller);
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+private:
+    struct counter {
+        Key key;
+        size_type count;
+        size_type error;
+        size_type heap_pos;
+    };
+
+    bool bounded_() const noexcept { return max_counters_ != 0; }
+
+    item to_item_(size_type id) const
+    {
+        const counter& c = counters_[id];
+        return item{c.key, c.count, c.error};
+    }
+
+    void increment_(const Key& k)
+    {
+        auto it = index_.find(k);
+        if (it != index_.end()) {
+            counter& c = counters_[it->second];
+            ++c.count;
+            fix_(c.heap_pos);
+        } else if (not bounded_() || heap_.size() < max_counters_) {
+            size_type id = allocate_counter_(k);
+            heap_.push_back(id);
+            counters_[id].heap_pos = heap_.size() - 1;
+            index_.emplace(k, id);
+            sift_up_(heap_.size() - 1);
+        } else {
+            // Space-Saving: take over the counter with the smallest count.
+            size_type id = heap_[0];
+            counter& c = counters_[id];
+            index_.erase(c.key);
+            c.key = k;
+            c.error = c.count;
+            ++c.count;
+            index_.emplace(k, id);
+            sift_down_(0);
+        }
+    }
+
+    void decrement_(const Key& k)
+    {
+        auto it = index_.find(k);
+        size_type id;
+        if (it != index_.end()) {
+            id = it->second;
+        } else {
+            // Only possible in bounded mode, where the key's counter was
+            // reassigned while it was still in the window. Its occurrence
+            // was folded into the smallest counter at that time, so take
+            // it back from the smallest counter now; this keeps the sum of
+            // all counts equal to the window size.
+            assert(bounded_());
+            id = heap_[0];
+        }
+        counter& c = counters_[id];
+        if (--c.count == 0) {
+            index_.erase(c.key);
+            remove_from_heap_(c.heap_pos);
+            free_.push_back(id);
+        } else {
+            c.error = std::min(c.error, c.count);
+            fix_(c.heap_pos);
+        }
+    }
+
+    size_type allocate_counter_(const Key& k)
+    {
+        if (free_.empty()) {
+            counters_.push_back(counter{k, 1, 0, 0});
+            return counters_.size() - 1;
+        }
+        size_type id = free_.back();
+        free_.pop_back();
+        counters_[id] = counter{k, 1, 0, 0};
+        return id;
+    }
+
+    static size_type parent_(size_type child) { return (child - 1) / 2; }
+    static size_type left_child_(size_type parent) { return parent * 2 + 1; }
+    static size_type right_child_(size_type parent) { return parent * 2 + 2; }
+
+    // In exact mode the largest count is on top; in bounded mode, the smallest.
+    bool before_(size_type a, size_type b) const
+    {
+        size_type ca = counters_[heap_[a]].count;
+        size_type cb = counters_[heap_[b]].count;
+        return bounded_() ? (ca < cb) : (cb < ca);
+    }
+
+    void swap_(size_type a, size_type b)
+    {
+        using std::swap;
+        swap(heap_[a], heap_[b]);
+        counters_[heap_[a]].heap_pos = a;
+        counters_[heap_[b]].heap_pos = b;
+    }
+
+    void fix_(size_type pos)
+    {
+        if (pos != 0 && before_(pos, parent_(pos))) {
+            sift_up_(pos);
+        } else {
+            sift_down_(pos);
+        }
+    }
+
+    void sift_up_(size_type idx)
+    {
+        while (idx != 0) {
+            size_type parent = parent_(idx);
+            if (before_(idx, parent)) {
+                swap_(idx, parent);
+                idx = parent;
+            } else {
+                return;
+            }
+        }
+    }
+
+    void sift_down_(size_type idx)
+    {
+        const size_type size = heap_.size();
+        while (left_child_(idx) < size) {
+            size_type best = left_child_(idx);
+            size_type right = right_child_(idx);
+            if (right < size && before_(right, best)) {
+                best = right;
+            }
+            if (not before_(best, idx)) {
+                return;
+            }
+            swap_(idx, best);
+            idx = best;
+        }
+    }
+
+    void remove_from_heap_(size_type pos)
+    {
+        const size_type last = heap_.size() - 1;
+        if (pos != last) {
+            swap_(pos, last);
+        }
+        heap_.pop_back();
+        if (pos != last) {
+            fix_(pos);
+        }
+    }
+
+    std::vector<Key> window_buffer_;
+    ring_span<Key, null_popper<Key>> window_;
+    size_type max_counters_;
+    std::vector<counter> counters_;
+    std::vector<size_type> free_;
+    std::vector<size_type> heap_;  // counter ids, as an indexed binary heap
+    std::unordered_map<Key, size_type, Hash> index_;
+};
+
+} } // namespace std::experimental
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace std { namespace experimental {
+
+namespace detail {
+
+template<class Key>
+struct keyed_heap_entry {
+    Key key;
+    std::size_t index;
+};
+
+} // namespace detail
+
+// A heap_span for large elements ordered by a small key.
+//
+// The payloads stay where they are put in the payload array; the heap
+// itself is a separate, dense array of (key, index) entries, where `key`
+// is a cached copy of key_of(payload) and `index` says which payload slot
+// it belongs to. Sifting compares and swaps only entries, so a heap of
+// 128-byte records keyed on a 64-bit deadline touches 16 bytes per level
+// instead of two whole records.
+//
+// The entry array must be at least as long as the payload array. Entries
+// past size() are used to remember which payload slots are free.
+// A payload's key must not change while it is in the heap.
+//
+template<class T, class KeyOf, class Comparator = std::less<>>
+class keyed_heap_span
+{
+public:
+    using type = keyed_heap_span<T, KeyOf, Comparator>;
+    using value_type = T;
+    using pointer = T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+    using key_type = std::decay_t<decltype(std::declval<KeyOf&>()(std::declval<const T&>()))>;
+
+    using entry_type = detail::keyed_heap_entry<key_type>;
+
+    keyed_heap_span() = default;
+
+    template<class ContiguousIterator, class EntryIterator>
+    keyed_heap_span(ContiguousIterator begin, ContiguousIterator end, EntryIterator entries_begin, EntryIterator entries_end,
+                    KeyOf key_of = KeyOf(), Comparator cmp = Comparator()) noexcept :
+        data_(&*begin),
+        entries_(&*entries_begin),
+        size_(0),
+        capacity_(end - begin),
+        key_of_(std::move(key_of)),
+        less_(std::move(cmp))
+    {
+        assert(size_type(entries_end - entries_begin) >= capacity_);
+        for (size_type i = 0; i < capacity_; ++i) {
+            entries_[i].index = i;
+        }
+    }
+
+    reference top() noexcept { return data_[entries_[0].index]; }
+    const_reference top() const noexcept { return data_[entries_[0].index]; }
+    const key_type& top_key() const noexcept { return entries_[0].key; }
+
+    bool empty() const noexcept { return size_ == 0; }
+    bool full() const noexcept { return size_ == capacity_; }
+    size_type size() const noexcept { return size_; }
+    size_type capacity() const noexcept { return capacity_; }
+
+    void pop()
+    {
+        using std::swap;
+        assert(not empty());
+        --size_;
+        // The popped entry's payload slot is now free; park it past the end.
+        swap(entries_[0], entries_[size_]);
+        heapify_down_();
+    }
+
+    template<bool b=true, typename=std::enable_if_t<b && std::is_copy_assignable<T>::value>>
+    void push(const T& value)
+    {
+        if (full()) {
+            data_[entries_[0].index] = value;
+            replace_top_key_();
+        } else {
+            data_[entries_[size_].index] = value;
+            append_key_();
+        }
+    }
+
+    template<bool b=true, typename=std::enable_if_t<b && std::is_move_assignable<T>::value>>
+    void push(T&& value)
+    {
+        if (full()) {
+            data_[entries_[0].index] = std::move(value);
+            replace_top_key_();
+        } else {
+            data_[entries_[size_].index] = std::move(value);
+            append_key_();
+        }
+    }
+
+    template<typename... Args>
+    void emplace(Args&&... args)
+    {
+        if (full()) {
+            data_[entries_[0].index] = T(std::forward<Args>(args)...);
+            replace_top_key_();
+        } else {
+            data_[entries_[size_].index] = T(std::forward<Args>(args)...);
+            append_key_();
+        }
+    }
+
+    void swap(keyed_heap_span& rhs) noexcept
+    {
+        using std::swap;
+        swap(data_, rhs.data_);
+        swap(entries_, rhs.entries_);
+        swap(size_, rhs.size_);
+        swap(capacity_, rhs.capacity_);
+        swap(key_of_, rhs.key_of_);
+        swap(less_, rhs.less_);
+    }
+
+    friend void swap(keyed_heap_span& lhs, keyed_heap_span& rhs) noexcept(noexcept(lhs.swap(rhs)))
+    {
+        lhs.swap(rhs);
+    }
+
+private:
+    static size_type parent_(size_type child) { return (child - 1) / 2; }
+    static size_type left_child_(size_type parent) { return parent * 2 + 1; }
+    static size_type right_child_(size_type parent) { return parent * 2 + 2; }
+
+    bool less_at_(size_type a, size_type b) { return less_(entries_[a].key, entries_[b].key); }
+
+    void append_key_()
+    {
+        entries_[size_].key = key_of_(const_cast<const T&>(data_[entries_[size_].index]));
+        ++size_;
+        heapify_up_();
+    }
+
+    void replace_top_key_()
+    {
+        entries_[0].key = key_of_(const_cast<const T&>(data_[entries_[0].index]));
+        heapify_down_();
+    }
+
+    void heapify_up_()
+    {
+        using std::swap;
+        assert(size_ >= 1);
+        size_type idx = size_ - 1;
+        while (idx != 0) {
+            size_type parent = parent_(idx);
+            if (less_at_(idx, parent)) {
+                swap(entries_[idx], entries_[parent]);
+                idx = parent;
+            } else {
+                return;
+            }
+        }
+    }
+
+    void heapify_down_()
+    {
+        using std::swap;
+        size_type idx = 0;
+        while (right_child_(idx) < size_) {
+            size_type left = left_child_(idx);
+            size_type right = right_child_(idx);
+            size_type child = less_at_(right, left) ? right : left;
+            if (less_at_(child, idx)) {
+                swap(entries_[idx], entries_[child]);
+                idx = child;
+            } else {
+                return;
+            }
+        }
+        if (left_child_(idx) < size_) {
+            if (less_at_(left_child_(idx), idx)) {
+                swap(entries_[idx], entries_[left_child_(idx)]);
+            }
+        }
+    }
+
+    T *data_;
+    entry_type *entries_;
+    size_type size_;
+    size_type capacity_;
+    KeyOf key_of_;
+    Comparator less_;
+};
+
+} } // namespace std::experimental
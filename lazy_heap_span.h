@@ -0,0 +1,176 @@
+#pragma once
+
+#include "heap_span.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+namespace std { namespace experimental {
+
+namespace detail {
+
+template<class T>
+struct lazy_heap_entry {
+    T value;
+    std::uint64_t handle;
+};
+
+template<class T, class Comparator>
+struct lazy_heap_entry_less {
+    Comparator less;
+    bool operator()(const lazy_heap_entry<T>& a, const lazy_heap_entry<T>& b) { return less(a.value, b.value); }
+};
+
+} // namespace detail
+
+// A heap_span whose elements can be cancelled by handle.
+//
+// push() returns a handle for the new element. erase(handle) doesn't look
+// for the element; it only records a tombstone for the handle. top() and
+// pop() discard tombstoned elements as they reach the top. Once more than
+// `compaction_threshold` of the stored elements are tombstoned, all
+// tombstoned elements are removed in one linear pass and the heap is
+// rebuilt bottom-up, also in linear time.
+//
+// erase() returns false, and does nothing, if the handle's element has
+// already been popped or erased, so a cancellation that loses the race
+// with pop() is harmless. To tell, the heap keeps a hash map entry for
+// every element it holds, dead or alive.
+//
+// Unlike heap_span, pushing into a full heap doesn't replace the top:
+// that would silently invalidate the top's handle. Instead push() makes
+// room by compacting if there are tombstones, and otherwise refuses,
+// returning no_handle.
+//
+template<class T, class Comparator = std::less<>>
+class lazy_heap_span
+{
+public:
+    using type = lazy_heap_span<T, Comparator>;
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+    using handle_type = std::uint64_t;
+    using entry_type = detail::lazy_heap_entry<T>;
+
+    static constexpr handle_type no_handle = UINT64_MAX;
+
+    template<class ContiguousIterator>
+    lazy_heap_span(ContiguousIterator begin, ContiguousIterator end, Comparator cmp = Comparator(), double compaction_threshold = 0.5) :
+        data_(&*begin),
+        capacity_(end - begin),
+        heap_(begin, end, 0, entry_less{cmp}),
+        less_(std::move(cmp)),
+        threshold_(compaction_threshold),
+        next_handle_(0),
+        tombstones_(0)
+    {}
+
+    reference top() { skip_tombstones_(); return heap_.top().value; }
+
+    bool empty() const noexcept { return size() == 0; }
+    bool full() const noexcept { return heap_.full() && tombstones_ == 0; }
+    size_type size() const noexcept { return heap_.size() - tombstones_; }
+    size_type capacity() const noexcept { return capacity_; }
+    size_type tombstones() const noexcept { return tombstones_; }
+
+    void pop()
+    {
+        skip_tombstones_();
+        assert(not heap_.empty());
+        handles_.erase(heap_.top().handle);
+        heap_.pop();
+    }
+
+    // Returns no_handle, and pushes nothing, if the heap is full of live elements.
+    template<class U>
+    handle_type push(U&& value)
+    {
+        if (heap_.full()) {
+            if (tombstones_ == 0) {
+                return no_handle;
+            }
+            compact_();
+        }
+        handle_type h = next_handle_++;
+        handles_.emplace(h, false);
+        heap_.push(entry_type{T(std::forward<U>(value)), h});
+        return h;
+    }
+
+    // Returns whether h's element was still in the heap.
+    bool erase(handle_type h)
+    {
+        auto it = handles_.find(h);
+        if (it == handles_.end() || it->second) {
+            return false;
+        }
+        it->second = true;
+        ++tombstones_;
+        if (double(tombstones_) > threshold_ * double(heap_.size())) {
+            compact_();
+        }
+        return true;
+    }
+
+    // Remove every tombstoned element now.
+    void compact()
+    {
+        if (tombstones_ != 0) {
+            compact_();
+        }
+    }
+
+private:
+    using entry_less = detail::lazy_heap_entry_less<T, Comparator>;
+
+    void skip_tombstones_()
+    {
+        while (not heap_.empty()) {
+            auto it = handles_.find(heap_.top().handle);
+            assert(it != handles_.end());
+            if (not it->second) {
+                return;
+            }
+            handles_.erase(it);
+            --tombstones_;
+            heap_.pop();
+        }
+    }
+
+    void compact_()
+    {
+        entry_type *last = std::remove_if(data_, data_ + heap_.size(), [&](const entry_type& e) {
+            auto it = handles_.find(e.handle);
+            if (not it->second) {
+                return false;
+            }
+            handles_.erase(it);
+            return true;
+        });
+        assert(size_type(data_ + heap_.size() - last) == tombstones_);
+        tombstones_ = 0;
+        heap_ = heap_span<entry_type, entry_less>(data_, data_ + capacity_, size_type(last - data_), entry_less{less_});
+        heap_.make_heap();
+    }
+
+    entry_type *data_;
+    size_type capacity_;
+    heap_span<entry_type, entry_less> heap_;
+    Comparator less_;
+    double threshold_;
+    handle_type next_handle_;
+    std::unordered_map<handle_type, bool> handles_;  // every element in the heap: erased?
+    size_type tombstones_;
+};
+
+template<class T, class Comparator>
+constexpr typename lazy_heap_span<T, Comparator>::handle_type lazy_heap_span<T, Comparator>::no_handle;
+
+} } // namespace std::experimental
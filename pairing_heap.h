@@ -0,0 +1,226 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+namespace std { namespace experimental {
+
+// Derive from pairing_heap_hook to be linkable into a pairing_heap.
+// An object can be in at most one heap at a time.
+struct pairing_heap_hook {
+    pairing_heap_hook *child_ = nullptr;    // leftmost child
+    pairing_heap_hook *sibling_ = nullptr;  // next sibling to the right
+    pairing_heap_hook *prev_ = nullptr;     // left sibling, or parent if leftmost; null for the root
+};
+
+// An intrusive, non-owning pairing heap (Fredman, Sedgewick, Sleator and
+// Tarjan 1986) over objects that stay where they are.
+//
+// Like heap_span, it neither allocates nor owns anything; unlike
+// heap_span, elements are never moved. The links live in a
+// pairing_heap_hook base of each element, so the caller decides where
+// elements live and may keep pointers to them.
+//
+// push(), merge() and decrease_key() are O(1); pop() and erase() are
+// amortized O(log n). After making an element's key smaller (in the
+// Comparator's sense) while it is in the heap, call decrease_key() on it.
+//
+template<class T, class Comparator = std::less<>>
+class pairing_heap
+{
+public:
+    using type = pairing_heap<T, Comparator>;
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+
+    explicit pairing_heap(Comparator cmp = Comparator()) noexcept :
+        root_(nullptr),
+        size_(0),
+        less_(std::move(cmp))
+    {}
+
+    // A pairing_heap is just a pointer to its root; copying one would
+    // leave two heaps sharing the same nodes.
+    pairing_heap(const pairing_heap&) = delete;
+    pairing_heap& operator=(const pairing_heap&) = delete;
+
+    pairing_heap(pairing_heap&& rhs) noexcept :
+        root_(rhs.root_),
+        size_(rhs.size_),
+        less_(std::move(rhs.less_))
+    {
+        rhs.root_ = nullptr;
+        rhs.size_ = 0;
+    }
+
+    reference top() noexcept { assert(root_); return value_(root_); }
+    const_reference top() const noexcept { assert(root_); return value_(root_); }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+
+    void push(T& elt) noexcept
+    {
+        pairing_heap_hook *node = &elt;
+        node->child_ = node->sibling_ = node->prev_ = nullptr;
+        root_ = meld_(root_, node);
+        ++size_;
+    }
+
+    void pop() noexcept
+    {
+        assert(not empty());
+        pairing_heap_hook *old = root_;
+        root_ = combine_siblings_(old->child_);
+        if (root_) {
+            root_->prev_ = nullptr;
+        }
+        old->child_ = nullptr;
+        --size_;
+    }
+
+    // Call after making elt's key smaller.
+    void decrease_key(T& elt) noexcept
+    {
+        pairing_heap_hook *node = &elt;
+        if (node == root_) {
+            return;
+        }
+        cut_(node);
+        root_ = meld_(root_, node);
+    }
+
+    // Remove elt, wherever it is in the heap.
+    void erase(T& elt) noexcept
+    {
+        pairing_heap_hook *node = &elt;
+        if (node == root_) {
+            pop();
+            return;
+        }
+        cut_(node);
+        pairing_heap_hook *sub = combine_siblings_(node->child_);
+        node->child_ = nullptr;
+        if (sub) {
+            sub->prev_ = nullptr;
+            root_ = meld_(root_, sub);
+        }
+        --size_;
+    }
+
+    // Move every element of rhs into *this, leaving rhs empty. Merging a
+    // heap with itself does nothing.
+    void merge(pairing_heap& rhs) noexcept
+    {
+        if (&rhs == this) {
+            return;
+        }
+        root_ = meld_(root_, rhs.root_);
+        size_ += rhs.size_;
+        rhs.root_ = nullptr;
+        rhs.size_ = 0;
+    }
+
+    void swap(pairing_heap& rhs) noexcept
+    {
+        using std::swap;
+        swap(root_, rhs.root_);
+        swap(size_, rhs.size_);
+        swap(less_, rhs.less_);
+    }
+
+    friend void swap(pairing_heap& lhs, pairing_heap& rhs) noexcept(noexcept(lhs.swap(rhs)))
+    {
+        lhs.swap(rhs);
+    }
+
+private:
+    static T& value_(pairing_heap_hook *node) noexcept { return static_cast<T&>(*node); }
+
+    bool less_node_(pairing_heap_hook *a, pairing_heap_hook *b) { return less_(value_(a), value_(b)); }
+
+    // Link two roots; the larger becomes the leftmost child of the smaller.
+    pairing_heap_hook *meld_(pairing_heap_hook *a, pairing_heap_hook *b) noexcept
+    {
+        if (a == nullptr) {
+            return b;
+        }
+        if (b == nullptr) {
+            return a;
+        }
+        if (less_node_(b, a)) {
+            std::swap(a, b);
+        }
+        b->sibling_ = a->child_;
+        if (a->child_) {
+            a->child_->prev_ = b;
+        }
+        b->prev_ = a;
+        a->child_ = b;
+        a->sibling_ = nullptr;
+        a->prev_ = nullptr;
+        return a;
+    }
+
+    // Detach node (and its subtree) from its parent or left sibling.
+    static void cut_(pairing_heap_hook *node) noexcept
+    {
+        pairing_heap_hook *prev = node->prev_;
+        assert(prev != nullptr);
+        if (prev->child_ == node) {
+            prev->child_ = node->sibling_;
+        } else {
+            prev->sibling_ = node->sibling_;
+        }
+        if (node->sibling_) {
+            node->sibling_->prev_ = prev;
+        }
+        node->sibling_ = nullptr;
+        node->prev_ = nullptr;
+    }
+
+    // The standard two-pass pairing: meld siblings left to right in pairs,
+    // then meld the results right to left. The pairs are threaded through
+    // their sibling_ pointers, so this needs no extra storage.
+    pairing_heap_hook *combine_siblings_(pairing_heap_hook *first) noexcept
+    {
+        if (first == nullptr) {
+            return nullptr;
+        }
+        pairing_heap_hook *pairs = nullptr;  // stack of melded pairs, most recent first
+        while (first) {
+            pairing_heap_hook *a = first;
+            pairing_heap_hook *b = a->sibling_;
+            first = b ? b->sibling_ : nullptr;
+            a->sibling_ = nullptr;
+            a->prev_ = nullptr;
+            if (b) {
+                b->sibling_ = nullptr;
+                b->prev_ = nullptr;
+            }
+            pairing_heap_hook *m = meld_(a, b);
+            m->sibling_ = pairs;
+            pairs = m;
+        }
+        pairing_heap_hook *result = pairs;
+        pairs = pairs->sibling_;
+        result->sibling_ = nullptr;
+        while (pairs) {
+            pairing_heap_hook *next = pairs->sibling_;
+            pairs->sibling_ = nullptr;
+            result = meld_(result, pairs);
+            pairs = next;
+        }
+        return result;
+    }
+
+    pairing_heap_hook *root_;
+    size_type size_;
+    Comparator less_;
+};
+
+} } // namespace std::experimental
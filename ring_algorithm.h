@@ -0,0 +1,131 @@
+#pragma once
+
+#include "ring_span.h"
+
+#include <cassert>
+#include <cstddef>
+#include <future>
+#include <iterator>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace std { namespace experimental {
+
+namespace detail {
+
+// Rings smaller than this many elements per thread aren't worth splitting.
+constexpr std::size_t parallel_ring_grain = 16384;
+
+inline unsigned parallel_ring_threads(std::size_t n, unsigned nthreads)
+{
+    if (nthreads == 0) {
+        nthreads = std::thread::hardware_concurrency();
+        if (nthreads == 0) {
+            nthreads = 1;
+        }
+    }
+    std::size_t useful = (n + parallel_ring_grain - 1) / parallel_ring_grain;
+    if (useful < nthreads) {
+        nthreads = unsigned(useful);
+    }
+    return (nthreads == 0) ? 1 : nthreads;
+}
+
+// Split the logical positions [0, n) into `chunks` balanced pieces and call
+// f(chunk, pos, count) for each, the first on the calling thread and the
+// rest asynchronously. Exceptions thrown by f are propagated.
+template<class F>
+void parallel_ring_chunks(std::size_t n, unsigned chunks, F&& f)
+{
+    std::vector<std::future<void>> futures;
+    futures.reserve(chunks);
+    const std::size_t base = n / chunks;
+    const std::size_t extra = n % chunks;
+    std::size_t pos = base + (extra != 0);
+    for (unsigned c = 1; c < chunks; ++c) {
+        const std::size_t count = base + (c < extra);
+        futures.push_back(std::async(std::launch::async, [&f, c, pos, count]() { f(c, pos, count); }));
+        pos += count;
+    }
+    f(0u, std::size_t(0), base + (extra != 0));
+    for (auto&& fut : futures) {
+        fut.get();
+    }
+}
+
+} // namespace detail
+
+// Parallel algorithms over the contents of a ring_span. The logical range
+// is cut into balanced chunks, one per thread, and each chunk is walked
+// as (at most) two plain pointer ranges, so the seam where the ring wraps
+// around costs nothing inside the loops. `nthreads == 0` means
+// std::thread::hardware_concurrency(); small rings run on the calling
+// thread only.
+
+template<class T, class Popper, class F>
+void parallel_for_each(ring_span<T, Popper>& rs, F f, unsigned nthreads = 0)
+{
+    const std::size_t n = rs.size();
+    detail::parallel_ring_chunks(n, detail::parallel_ring_threads(n, nthreads), [&](unsigned, std::size_t pos, std::size_t count) {
+        detail::for_each_run(rs, pos, count, [&](T *p, std::size_t len) {
+            for (T *last = p + len; p != last; ++p) {
+                f(*p);
+            }
+        });
+    });
+}
+
+// out[i] = f(rs[i]) for each position i; returns out + rs.size().
+template<class T, class Popper, class RandomAccessIterator, class F>
+RandomAccessIterator parallel_transform(const ring_span<T, Popper>& rs, RandomAccessIterator out, F f, unsigned nthreads = 0)
+{
+    const std::size_t n = rs.size();
+    detail::parallel_ring_chunks(n, detail::parallel_ring_threads(n, nthreads), [&](unsigned, std::size_t pos, std::size_t count) {
+        auto dest = out + pos;
+        detail::for_each_run(rs, pos, count, [&](const T *p, std::size_t len) {
+            for (const T *last = p + len; p != last; ++p, ++dest) {
+                *dest = f(*p);
+            }
+        });
+    });
+    return out + n;
+}
+
+// Folds the ring front to back with `op`, which must be associative:
+// each chunk is folded separately and the partial results are combined
+// in order. Only the first chunk starts from `init`; the others start
+// from their own first element.
+template<class T, class Popper, class U, class BinaryOp>
+U parallel_reduce(const ring_span<T, Popper>& rs, U init, BinaryOp op, unsigned nthreads = 0)
+{
+    const std::size_t n = rs.size();
+    const unsigned chunks = detail::parallel_ring_threads(n, nthreads);
+    std::vector<U> partials;
+    partials.reserve(chunks);
+    partials.push_back(std::move(init));
+    for (unsigned c = 1; c < chunks; ++c) {
+        partials.push_back(partials.front());  // overwritten below
+    }
+    detail::parallel_ring_chunks(n, chunks, [&](unsigned c, std::size_t pos, std::size_t count) {
+        bool first = (c != 0);
+        U& acc = partials[c];
+        detail::for_each_run(rs, pos, count, [&](const T *p, std::size_t len) {
+            const T *last = p + len;
+            if (first && p != last) {
+                acc = U(*p++);
+                first = false;
+            }
+            for (; p != last; ++p) {
+                acc = op(std::move(acc), *p);
+            }
+        });
+    });
+    U result = std::move(partials.front());
+    for (unsigned c = 1; c < chunks; ++c) {
+        result = op(std::move(result), std::move(partials[c]));
+    }
+    return result;
+}
+
+} } // namespace std::experimental
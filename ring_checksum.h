@@ -0,0 +1,155 @@
+#pragma once
+
+#include "ring_span.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+namespace std { namespace experimental {
+
+namespace detail {
+
+// Slicing-by-8 tables for the CRC-32C (Castagnoli) polynomial.
+struct crc32c_tables {
+    std::uint32_t t[8][256];
+
+    crc32c_tables() noexcept
+    {
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c >> 1) ^ (0x82F63B78u & (0u - (c & 1)));
+            }
+            t[0][i] = c;
+        }
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            for (int s = 1; s < 8; ++s) {
+                t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xFF];
+            }
+        }
+    }
+
+    static const crc32c_tables& get() noexcept
+    {
+        static const crc32c_tables tables;
+        return tables;
+    }
+};
+
+inline std::uint32_t crc32c_software(std::uint32_t crc, const unsigned char *p, std::size_t n) noexcept
+{
+    const auto& t = crc32c_tables::get().t;
+    while (n >= 8) {
+        std::uint32_t lo;
+        std::uint32_t hi;
+        std::memcpy(&lo, p, 4);
+        std::memcpy(&hi, p + 4, 4);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        lo = __builtin_bswap32(lo);
+        hi = __builtin_bswap32(hi);
+#endif
+        lo ^= crc;
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+              t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+        p += 8;
+        n -= 8;
+    }
+    while (n != 0) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p) & 0xFF];
+        ++p;
+        --n;
+    }
+    return crc;
+}
+
+#if defined(__SSE4_2__)
+inline std::uint32_t crc32c_hardware(std::uint32_t crc, const unsigned char *p, std::size_t n) noexcept
+{
+#if defined(__x86_64__)
+    std::uint64_t crc64 = crc;
+    while (n >= 8) {
+        std::uint64_t v;
+        std::memcpy(&v, p, 8);
+        crc64 = _mm_crc32_u64(crc64, v);
+        p += 8;
+        n -= 8;
+    }
+    crc = std::uint32_t(crc64);
+#endif
+    while (n >= 4) {
+        std::uint32_t v;
+        std::memcpy(&v, p, 4);
+        crc = _mm_crc32_u32(crc, v);
+        p += 4;
+        n -= 4;
+    }
+    while (n != 0) {
+        crc = _mm_crc32_u8(crc, *p);
+        ++p;
+        --n;
+    }
+    return crc;
+}
+#endif
+
+} // namespace detail
+
+// An incremental CRC-32C. Feed it bytes with update() as they arrive, and
+// read the checksum of everything so far with value().
+//
+// When compiled with SSE4.2 enabled (e.g. -msse4.2 or -march=native) this
+// uses the crc32 instruction eight bytes at a time; otherwise it uses a
+// portable slicing-by-8 table. Both give identical results.
+//
+class crc32c
+{
+public:
+    crc32c() noexcept : state_(0xFFFFFFFFu) {}
+
+    crc32c& update(const void *data, std::size_t bytes) noexcept
+    {
+        auto p = static_cast<const unsigned char *>(data);
+#if defined(__SSE4_2__)
+        state_ = detail::crc32c_hardware(state_, p, bytes);
+#else
+        state_ = detail::crc32c_software(state_, p, bytes);
+#endif
+        return *this;
+    }
+
+    // Checksum the ring's contents, front to back, one contiguous run at a
+    // time rather than one element at a time.
+    template<class T, class Popper>
+    crc32c& update(const ring_span<T, Popper>& rs) noexcept
+    {
+        return update(rs, 0, rs.size());
+    }
+
+    // Checksum `count` elements starting `pos` elements after the front;
+    // e.g. update(rs, rs.size() - n, n) after a bulk append of n elements.
+    template<class T, class Popper>
+    crc32c& update(const ring_span<T, Popper>& rs, std::size_t pos, std::size_t count) noexcept
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "only the bytes of trivially copyable types are meaningful to checksum");
+        detail::for_each_run(rs, pos, count, [this](const T *p, std::size_t n) {
+            update(p, n * sizeof(T));
+        });
+        return *this;
+    }
+
+    std::uint32_t value() const noexcept { return ~state_; }
+
+    void reset() noexcept { state_ = 0xFFFFFFFFu; }
+
+private:
+    std::uint32_t state_;
+};
+
+} } // namespace std::experimental
@@ -2,6 +2,8 @@
 
 // Reference implementation of P0059R1 + errata.
 
+#include "trivially_relocatable.h"
+
 #include <cassert>
 #include <cstddef>
 #include <iterator>
@@ -12,6 +14,7 @@ namespace std { namespace experimental {
 
 namespace detail {
     template<class, bool> class ring_iterator;
+    template<class RingSpan, class F> void for_each_run(RingSpan&, std::size_t, std::size_t, F&&);
 } // namespace detail
 
 template<class T>
@@ -83,6 +86,24 @@ public:
     size_type size() const noexcept { return size_; }
     size_type capacity() const noexcept { return capacity_; }
 
+    // Extension: the contents as (at most) two contiguous runs, front first.
+    std::pair<pointer, size_type> array_one() noexcept { return {data_ + front_idx_, first_run_()}; }
+    std::pair<pointer, size_type> array_two() noexcept { return {data_, size_ - first_run_()}; }
+    std::pair<const T*, size_type> array_one() const noexcept { return {data_ + front_idx_, first_run_()}; }
+    std::pair<const T*, size_type> array_two() const noexcept { return {data_, size_ - first_run_()}; }
+
+    // Extension: rotate the whole buffer so that the front element is at
+    // its start, making the contents one contiguous run, and return it.
+    // Trivially relocatable elements are moved with memmove.
+    pointer linearize()
+    {
+        if (front_idx_ != 0) {
+            detail::relocating_rotate(data_, data_ + front_idx_, data_ + capacity_);
+            front_idx_ = 0;
+        }
+        return data_;
+    }
+
     auto pop_front()
     {
         assert(not empty());
@@ -91,6 +112,23 @@ public:
         return popper_(elt);
     }
 
+    // Extension: call f(elt) on each of the n front elements, in place and
+    // front first, then retire them all with a single index update. The
+    // popper is not called; the elements stay in the buffer as f left them,
+    // to be overwritten by later pushes.
+    template<class F>
+    void consume_front(size_type n, F&& f)
+    {
+        assert(n <= size_);
+        detail::for_each_run(*this, 0, n, [&](pointer p, size_type len) {
+            for (pointer last = p + len; p != last; ++p) {
+                f(*p);
+            }
+        });
+        front_idx_ = (front_idx_ + n) % capacity_;
+        size_ -= n;
+    }
+
     auto pop_back()
     {
         assert(not empty());
@@ -189,6 +227,10 @@ private:
     reference at(size_type i) noexcept { return data_[(front_idx_ + i) % capacity_]; }
     const_reference at(size_type i) const noexcept { return data_[(front_idx_ + i) % capacity_]; }
 
+    size_type first_run_() const noexcept {
+        return (size_ < capacity_ - front_idx_) ? size_ : (capacity_ - front_idx_);
+    }
+
     reference front_() noexcept { return *(data_ + front_idx_); }
     const_reference front_() const noexcept { return *(data_ + front_idx_); }
     reference back_() noexcept { return *(data_ + (front_idx_ + size_ - 1) % capacity_); }
@@ -226,6 +268,35 @@ private:
 
 namespace detail {
 
+// Calls f(ptr, n) for each contiguous run making up the `count` elements
+// starting `pos` elements after the front of the ring, front first.
+template<class RingSpan, class F>
+void for_each_run(RingSpan& rs, std::size_t pos, std::size_t count, F&& f)
+{
+    assert(pos + count <= rs.size());
+    auto one = rs.array_one();
+    if (pos < one.second) {
+        std::size_t n = (count < one.second - pos) ? count : (one.second - pos);
+        f(one.first + pos, n);
+        count -= n;
+        pos = 0;
+    } else {
+        pos -= one.second;
+    }
+    if (count != 0) {
+        f(rs.array_two().first + pos, count);
+    }
+}
+
+// The element `pos` elements after the front of the ring.
+template<class RingSpan>
+auto element_at(RingSpan& rs, std::size_t pos) noexcept -> decltype(*rs.array_one().first)
+{
+    assert(pos < rs.size());
+    auto one = rs.array_one();
+    return (pos < one.second) ? one.first[pos] : rs.array_two().first[pos - one.second];
+}
+
 template<class RV, bool is_const>
 class ring_iterator
 {
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "ring_span.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace std { namespace experimental {
+
+// Distinct-count estimation over a sliding time window (Sliding HyperLogLog,
+// Chabchoub and Hebrail 2010).
+//
+// Each of the 2^precision registers keeps a small ring_span of
+// (timestamp, rank) candidates: an observation is kept only as long as no
+// later observation in the same register has an equal or greater rank.
+// The candidates in each ring are therefore ordered by increasing time and
+// decreasing rank, so the register value for any window ending "now" is
+// the rank of the first candidate that is inside the window.
+//
+// estimate(window, now) answers for any window up to `max_window`.
+// Candidates older than max_window are discarded as new observations
+// arrive. If a register's ring fills up, its oldest candidate is
+// forgotten, which can only affect the longest windows; a handful of
+// candidates per register is plenty in practice.
+//
+template<class Key, class Hash = std::hash<Key>, class Time = std::uint64_t>
+class sliding_hyperloglog
+{
+public:
+    using key_type = Key;
+    using time_type = Time;
+    using size_type = std::size_t;
+
+    struct candidate {
+        Time time;
+        std::uint8_t rank;
+    };
+
+    sliding_hyperloglog(unsigned precision, Time max_window, size_type candidates_per_register = 8, Hash hash = Hash()) :
+        precision_(precision),
+        max_window_(max_window),
+        hash_(std::move(hash)),
+        buffer_((size_type(1) << precision) * candidates_per_register)
+    {
+        assert(4 <= precision && precision <= 18);
+        assert(candidates_per_register != 0);
+        const size_type m = size_type(1) << precision;
+        registers_.reserve(m);
+        for (size_type i = 0; i < m; ++i) {
+            auto first = buffer_.begin() + i * candidates_per_register;
+            registers_.emplace_back(first, first + candidates_per_register, first, 0);
+        }
+    }
+
+    // Each register's ring is a slice of buffer_, not a copy of it.
+    sliding_hyperloglog(const sliding_hyperloglog&) = delete;
+    sliding_hyperloglog& operator=(const sliding_hyperloglog&) = delete;
+
+    void insert(const Key& k, const Time& now)
+    {
+        const std::uint64_t h = mix_(static_cast<std::uint64_t>(hash_(k)));
+        const size_type idx = size_type(h >> (64 - precision_));
+        const std::uint64_t w = h << precision_;
+        const std::uint8_t rank = std::uint8_t((w == 0) ? (64 - precision_ + 1) : (__builtin_clzll(w) + 1));
+
+        auto& reg = registers_[idx];
+        const Time cutoff = (now < max_window_) ? Time() : Time(now - max_window_);
+        while (not reg.empty() && reg.front().time < cutoff) {
+            reg.pop_front();
+        }
+        while (not reg.empty() && reg.back().rank <= rank) {
+            reg.pop_back();
+        }
+        reg.push_back(candidate{now, rank});
+    }
+
+    // Estimated number of distinct keys inserted in [now - window, now].
+    double estimate(const Time& window, const Time& now) const
+    {
+        assert(window <= max_window_);
+        const Time cutoff = (now < window) ? Time() : Time(now - window);
+        const size_type m = registers_.size();
+        double sum = 0;
+        size_type zeros = 0;
+        for (auto&& reg : registers_) {
+            int rank = 0;
+            for (auto&& c : reg) {
+                if (not (c.time < cutoff)) {
+                    rank = c.rank;
+                    break;
+                }
+            }
+            sum += std::ldexp(1.0, -rank);
+            zeros += (rank == 0);
+        }
+        const double dm = double(m);
+        double e = alpha_(m) * dm * dm / sum;
+        if (e <= 2.5 * dm && zeros != 0) {
+            e = dm * std::log(dm / double(zeros));  // linear counting
+        }
+        return e;
+    }
+
+    size_type registers() const noexcept { return registers_.size(); }
+    Time max_window() const noexcept { return max_window_; }
+
+private:
+    static std::uint64_t mix_(std::uint64_t x) noexcept
+    {
+        // The splitmix64 finalizer; std::hash is often the identity.
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    static double alpha_(size_type m) noexcept
+    {
+        switch (m) {
+            case 16: return 0.673;
+            case 32: return 0.697;
+            case 64: return 0.709;
+            default: return 0.7213 / (1.0 + 1.079 / double(m));
+        }
+    }
+
+    unsigned precision_;
+    Time max_window_;
+    Hash hash_;
+    std::vector<candidate> buffer_;
+    std::vector<ring_span<candidate, null_popper<candidate>>> registers_;
+};
+
+} } // namespace std::experimental
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "heap_span.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+namespace std { namespace experimental {
+
+namespace detail {
+
+template<class Comparator, class Key>
+struct stable_heap_order {
+    static_assert(std::is_same<Comparator, void>::value, "stable_heap_span supports only std::less and std::greater");
+};
+
+template<class Key> struct stable_heap_order<std::less<>, Key> : std::false_type {};
+template<class Key> struct stable_heap_order<std::less<Key>, Key> : std::false_type {};
+template<class Key> struct stable_heap_order<std::greater<>, Key> : std::true_type {};
+template<class Key> struct stable_heap_order<std::greater<Key>, Key> : std::true_type {};
+
+template<std::size_t Bits>
+struct stable_heap_word {
+#if defined(__SIZEOF_INT128__)
+    static_assert(Bits <= 128, "key and sequence number don't fit in 128 bits");
+    using type = std::conditional_t<(Bits <= 64), std::uint64_t, unsigned __int128>;
+#else
+    static_assert(Bits <= 64, "key and sequence number don't fit in 64 bits");
+    using type = std::uint64_t;
+#endif
+};
+
+template<class Word, class T>
+struct stable_heap_entry {
+    Word word;
+    T value;
+};
+
+struct stable_heap_entry_less {
+    template<class Entry>
+    bool operator()(const Entry& a, const Entry& b) const noexcept { return a.word < b.word; }
+};
+
+} // namespace detail
+
+// A heap_span ordered by an integer key, in which elements with equal keys
+// pop in the order they were pushed.
+//
+// Rather than pairing each key with a sequence number and comparing the
+// two in turn, each element carries a single unsigned word: its key in the
+// high bits (sign-flipped for signed keys, and bit-inverted for
+// std::greater, so that unsigned order matches the requested order) and a
+// sequence number in the low SequenceBits bits. Sifting compares those
+// words with one integer comparison and never calls KeyOf. A key of up to
+// 32 bits with 32 sequence bits packs into a std::uint64_t; wider
+// combinations use unsigned __int128 where the compiler has it.
+//
+// When the sequence numbers run out, the heap is sorted (which keeps it a
+// valid heap) and the elements are renumbered from zero, in order, so the
+// capacity must be less than 2^SequenceBits.
+//
+template<class T, class KeyOf, class Comparator = std::less<>, unsigned SequenceBits = 32>
+class stable_heap_span
+{
+public:
+    using key_type = std::decay_t<decltype(std::declval<KeyOf&>()(std::declval<const T&>()))>;
+
+private:
+    static_assert(std::is_integral<key_type>::value, "stable_heap_span packs integer keys");
+    static_assert(SequenceBits >= 1 && SequenceBits < 64, "SequenceBits must be between 1 and 63");
+
+    static constexpr std::size_t key_bits = sizeof(key_type) * CHAR_BIT;
+    using ukey_type = std::make_unsigned_t<key_type>;
+
+public:
+    using type = stable_heap_span<T, KeyOf, Comparator, SequenceBits>;
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+    using word_type = typename detail::stable_heap_word<key_bits + SequenceBits>::type;
+    using entry_type = detail::stable_heap_entry<word_type, T>;
+
+    template<class ContiguousIterator>
+    stable_heap_span(ContiguousIterator begin, ContiguousIterator end, KeyOf key_of = KeyOf()) noexcept :
+        heap_(begin, end, 0),
+        key_of_(std::move(key_of)),
+        next_seq_(0)
+    {
+        // Renumbering needs a distinct sequence number for every element.
+        assert(heap_.capacity() <= max_seq_);
+    }
+
+    reference top() noexcept { return heap_.top().value; }
+    const_reference top() const noexcept { return heap_.top().value; }
+
+    bool empty() const noexcept { return heap_.empty(); }
+    bool full() const noexcept { return heap_.full(); }
+    size_type size() const noexcept { return heap_.size(); }
+    size_type capacity() const noexcept { return heap_.capacity(); }
+
+    void pop() { heap_.pop(); }
+
+    // As with heap_span, pushing into a full heap replaces the top.
+    void push(const T& value) { push_(T(value)); }
+    void push(T&& value) { push_(std::move(value)); }
+
+    template<typename... Args>
+    void emplace(Args&&... args) { push_(T(std::forward<Args>(args)...)); }
+
+private:
+    static constexpr bool reversed_ = detail::stable_heap_order<Comparator, key_type>::value;
+    static constexpr std::uint64_t max_seq_ = (std::uint64_t(1) << SequenceBits) - 1;
+    static constexpr ukey_type sign_flip_ = std::is_signed<key_type>::value ? ukey_type(ukey_type(1) << (key_bits - 1)) : ukey_type(0);
+
+    void push_(T&& value)
+    {
+        if (next_seq_ > max_seq_) {
+            renumber_();
+        }
+        word_type w = encode_(key_of_(const_cast<const T&>(value)), next_seq_++);
+        heap_.push(entry_type{w, std::move(value)});
+    }
+
+    static word_type encode_(key_type k, std::uint64_t seq) noexcept
+    {
+        ukey_type u = ukey_type(ukey_type(k) ^ sign_flip_);
+        if (reversed_) {
+            u = ukey_type(~u);
+        }
+        return (word_type(u) << SequenceBits) | word_type(seq);
+    }
+
+    void renumber_()
+    {
+        entry_type *first = &heap_.top();
+        const size_type n = heap_.size();
+        std::sort(first, first + n, detail::stable_heap_entry_less());
+        const word_type key_mask = ~word_type(max_seq_);
+        for (size_type i = 0; i < n; ++i) {
+            first[i].word = (first[i].word & key_mask) | word_type(i);
+        }
+        next_seq_ = n;
+        assert(next_seq_ <= max_seq_);
+    }
+
+    heap_span<entry_type, detail::stable_heap_entry_less> heap_;
+    KeyOf key_of_;
+    std::uint64_t next_seq_;
+};
+
+} } // namespace std::experimental
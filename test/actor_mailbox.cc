@@ -0,0 +1,209 @@
+#include "actor_mailbox.h"
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::experimental::actor_mailbox;
+using send_result = actor_mailbox<int>::send_result;
+
+void basic_test()
+{
+    actor_mailbox<std::unique_ptr<int>> mb(3);
+    assert(mb.capacity() == 4);
+    using result = actor_mailbox<std::unique_ptr<int>>::send_result;
+    assert(mb.try_send(std::make_unique<int>(0)) == result::schedule);
+    for (int i = 1; i < 4; ++i) {
+        assert(mb.try_send(std::make_unique<int>(i)) == result::sent);
+    }
+    assert(mb.try_send(std::make_unique<int>(4)) == result::full);
+
+    std::vector<int> got;
+    auto f = [&](std::unique_ptr<int>&& p) { got.push_back(*p); };
+    assert(mb.drain(3, f));  // one left: still scheduled
+    assert(got.size() == 3);
+    assert(mb.try_send(std::make_unique<int>(4)) == result::sent);
+    assert(not mb.drain(10, f));  // drained: idle
+    assert((got == std::vector<int>{0, 1, 2, 3, 4}));
+    assert(mb.empty());
+
+    // Idle again, so the next send schedules.
+    assert(mb.try_send(std::make_unique<int>(5)) == result::schedule);
+    assert(not mb.drain(10, f));
+    assert(got.back() == 5);
+}
+
+// A toy scheduler: a run queue of actors and some worker threads.
+struct actor {
+    actor_mailbox<int> mailbox{64};
+    std::atomic<int> running{0};
+    std::vector<int> last;  // last value seen from each sender
+    long received = 0;
+    std::function<void(int)> on_message;
+};
+
+struct scheduler {
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<actor *> runnable;
+    bool stop = false;
+    std::atomic<long> activations{0};
+
+    void schedule(actor *a)
+    {
+        std::lock_guard<std::mutex> lk(m);
+        runnable.push_back(a);
+        cv.notify_one();
+    }
+
+    void send(actor *a, int value)
+    {
+        send_result r;
+        while ((r = a->mailbox.try_send(value)) == send_result::full) {
+            std::this_thread::yield();
+        }
+        if (r == send_result::schedule) {
+            schedule(a);
+        }
+    }
+
+    void work()
+    {
+        for (;;) {
+            actor *a;
+            {
+                std::unique_lock<std::mutex> lk(m);
+                cv.wait(lk, [&] { return stop || not runnable.empty(); });
+                if (runnable.empty()) {
+                    return;
+                }
+                a = runnable.front();
+                runnable.pop_front();
+            }
+            ++activations;
+            bool again = a->mailbox.drain(16, [&](int v) {
+                // An actor must never run on two workers at once.
+                assert(a->running.exchange(1) == 0);
+                a->on_message(v);
+                a->running.store(0);
+            });
+            if (again) {
+                schedule(a);
+            }
+        }
+    }
+
+    void shutdown()
+    {
+        std::lock_guard<std::mutex> lk(m);
+        stop = true;
+        cv.notify_all();
+    }
+};
+
+void fan_in_test()
+{
+    const int senders = 4, per_sender = 50000;
+    scheduler s;
+    actor a;
+    a.last.assign(senders, -1);
+    std::atomic<long> done{0};
+    a.on_message = [&](int v) {
+        int sender = v % senders, seq = v / senders;
+        assert(seq > a.last[sender]);  // FIFO per sender
+        a.last[sender] = seq;
+        if (++a.received == long(senders) * per_sender) {
+            done = 1;
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int i = 0; i < 2; ++i) {
+        workers.emplace_back([&] { s.work(); });
+    }
+    std::vector<std::thread> threads;
+    for (int k = 0; k < senders; ++k) {
+        threads.emplace_back([&, k] {
+            for (int i = 0; i < per_sender; ++i) {
+                s.send(&a, i * senders + k);
+            }
+        });
+    }
+    for (auto&& t : threads) {
+        t.join();
+    }
+    while (not done) {
+        std::this_thread::yield();
+    }
+    s.shutdown();
+    for (auto&& t : workers) {
+        t.join();
+    }
+    assert(a.received == long(senders) * per_sender);
+    assert(a.mailbox.empty());
+    assert(s.activations <= a.received);
+}
+
+void ping_pong_test()
+{
+    // Two actors bouncing a counter: every send goes to an idle actor,
+    // so every send schedules.
+    const int rounds = 20000;
+    scheduler s;
+    actor ping, pong;
+    std::atomic<int> finished{0};
+    ping.on_message = [&](int v) {
+        ++ping.received;
+        if (v >= rounds) {
+            finished = 1;
+        } else {
+            s.send(&pong, v + 1);
+        }
+    };
+    pong.on_message = [&](int v) {
+        ++pong.received;
+        s.send(&ping, v + 1);
+    };
+    std::vector<std::thread> workers;
+    for (int i = 0; i < 2; ++i) {
+        workers.emplace_back([&] { s.work(); });
+    }
+    s.send(&ping, 0);
+    while (not finished) {
+        std::this_thread::yield();
+    }
+    s.shutdown();
+    for (auto&& t : workers) {
+        t.join();
+    }
+    assert(ping.received + pong.received == rounds + 1);
+}
+
+void many_actors_test()
+{
+    // Lots of small mailboxes on the heap, as a system of many actors
+    // would have them.
+    std::vector<std::unique_ptr<actor_mailbox<int>>> boxes;
+    for (int i = 0; i < 10000; ++i) {
+        boxes.push_back(std::make_unique<actor_mailbox<int>>(2));
+        assert(boxes.back()->try_send(i) == send_result::schedule);
+    }
+    for (int i = 0; i < 10000; ++i) {
+        int got = -1;
+        assert(not boxes[i]->drain(8, [&](int&& v) { got = v; }));
+        assert(got == i);
+    }
+}
+
+int main()
+{
+    basic_test();
+    fan_in_test();
+    ping_pong_test();
+    many_actors_test();
+}
@@ -0,0 +1,192 @@
+#include "batching_producer.h"
+#include "ring_span.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::experimental::batching_producer;
+using std::experimental::ring_span;
+
+// A clock the test moves by hand.
+struct manual_clock {
+    using duration = std::chrono::microseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<manual_clock>;
+    static constexpr bool is_steady = true;
+    static time_point current;
+    static time_point now() noexcept { return current; }
+    static void advance(duration d) { current += d; }
+};
+manual_clock::time_point manual_clock::current;
+
+// The shared side: a mutex-guarded ring, counting how often it's touched.
+template<class T>
+struct shared_ring {
+    std::vector<T> storage;
+    ring_span<T> ring;
+    std::mutex m;
+    std::condition_variable cv;
+    int handoffs = 0;
+
+    explicit shared_ring(std::size_t n) : storage(n), ring(storage.begin(), storage.end(), storage.begin(), 0) {}
+
+    template<class Batch>
+    void operator()(Batch& batch)
+    {
+        {
+            std::lock_guard<std::mutex> lk(m);
+            batch.consume_front(batch.size(), [&](T& x) { ring.push_back(std::move(x)); });
+            ++handoffs;
+        }
+        cv.notify_one();
+    }
+};
+
+template<class T>
+struct shared_sink {
+    shared_ring<T> *target;
+    template<class Batch>
+    void operator()(Batch& batch) { (*target)(batch); }
+};
+
+void size_trigger_test()
+{
+    shared_ring<int> shared(100);
+    std::vector<int> local(8);
+    {
+        batching_producer<int, shared_sink<int>, manual_clock> p(local.begin(), local.end(), 4, std::chrono::seconds(1), shared_sink<int>{&shared});
+        for (int i = 0; i < 10; ++i) {
+            p.push(i);
+        }
+        assert(shared.handoffs == 2);
+        assert(shared.ring.size() == 8);
+        assert(p.pending() == 2);
+    }
+    // The destructor flushed the last two.
+    assert(shared.handoffs == 3);
+    assert(shared.ring.size() == 10);
+    for (int i = 0; i < 10; ++i) {
+        assert(shared.ring.pop_front() == i);
+    }
+}
+
+void time_trigger_test()
+{
+    shared_ring<std::unique_ptr<int>> shared(100);
+    std::vector<std::unique_ptr<int>> local(16);
+    using sink = shared_sink<std::unique_ptr<int>>;
+    batching_producer<std::unique_ptr<int>, sink, manual_clock> p(local.begin(), local.end(), 16, std::chrono::microseconds(50), sink{&shared});
+
+    p.push(std::make_unique<int>(1));
+    manual_clock::advance(std::chrono::microseconds(20));
+    p.push(std::make_unique<int>(2));
+    assert(not p.poll());
+    assert(shared.handoffs == 0);
+
+    // 50us after the first item, the next push sends both...
+    manual_clock::advance(std::chrono::microseconds(30));
+    p.push(std::make_unique<int>(3));
+    assert(shared.handoffs == 1 && shared.ring.size() == 3);
+    assert(p.pending() == 0);
+
+    // ...and with no pushes, poll() does.
+    p.push(std::make_unique<int>(4));
+    manual_clock::advance(std::chrono::microseconds(49));
+    assert(not p.poll());
+    manual_clock::advance(std::chrono::microseconds(1));
+    assert(p.poll());
+    assert(not p.poll());
+    assert(shared.handoffs == 2 && shared.ring.size() == 4);
+    for (int i = 1; i <= 4; ++i) {
+        assert(*shared.ring.pop_front() == i);
+    }
+}
+
+void move_test()
+{
+    // Producers can live in a vector; moving one hands over its pending
+    // items, which are then flushed exactly once.
+    using producer = batching_producer<int, shared_sink<int>, manual_clock>;
+    shared_ring<int> shared(100);
+    std::vector<std::vector<int>> locals(3, std::vector<int>(8));
+    {
+        std::vector<producer> ps;
+        for (auto&& local : locals) {
+            ps.emplace_back(local.begin(), local.end(), 8, std::chrono::seconds(1), shared_sink<int>{&shared});
+            ps.back().push(int(ps.size()));  // pending across the reallocations
+        }
+        assert(shared.handoffs == 0);
+        producer p(std::move(ps[0]));
+        assert(p.pending() == 1 && ps[0].pending() == 0);
+        p.push(10);
+        ps[0] = std::move(ps[1]);
+        assert(ps[0].pending() == 1 && ps[1].pending() == 0);
+        assert(shared.handoffs == 0);
+    }
+    assert(shared.handoffs == 3);
+    assert(shared.ring.size() == 4);
+    std::vector<int> got;
+    while (not shared.ring.empty()) {
+        got.push_back(shared.ring.pop_front());
+    }
+    std::sort(got.begin(), got.end());
+    assert((got == std::vector<int>{1, 2, 3, 10}));
+}
+
+void threads_test()
+{
+    // Several producers batching into one consumer: everything arrives,
+    // in order per producer.
+    const int producers = 3, per_producer = 30000;
+    shared_ring<int> shared(4096);
+    std::vector<std::thread> threads;
+    for (int k = 0; k < producers; ++k) {
+        threads.emplace_back([&, k] {
+            std::vector<int> local(64);
+            batching_producer<int, shared_sink<int>> p(local.begin(), local.end(), 64, std::chrono::milliseconds(1), shared_sink<int>{&shared});
+            for (int i = 0; i < per_producer; ++i) {
+                // Don't overrun the consumer (the shared ring overwrites).
+                for (;;) {
+                    {
+                        std::lock_guard<std::mutex> lk(shared.m);
+                        if (shared.ring.size() + p.pending() + 1 < shared.ring.capacity()) {
+                            break;
+                        }
+                    }
+                    std::this_thread::yield();
+                }
+                p.push(i * producers + k);
+            }
+        });
+    }
+    std::vector<int> last(producers, -1);
+    int received = 0;
+    while (received < producers * per_producer) {
+        std::unique_lock<std::mutex> lk(shared.m);
+        shared.cv.wait_for(lk, std::chrono::milliseconds(1), [&] { return not shared.ring.empty(); });
+        while (not shared.ring.empty()) {
+            int v = shared.ring.pop_front();
+            assert(v / producers > last[v % producers]);
+            last[v % producers] = v / producers;
+            ++received;
+        }
+    }
+    for (auto&& t : threads) {
+        t.join();
+    }
+}
+
+int main()
+{
+    size_trigger_test();
+    time_trigger_test();
+    move_test();
+    threads_test();
+}
@@ -0,0 +1,202 @@
+#include "binary_logger.h"
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::experimental::binary_logger;
+using std::experimental::detail::spsc_record_ring;
+
+void record_ring_test()
+{
+    spsc_record_ring ring(64);
+    assert(ring.capacity() == 64);
+    std::vector<std::uint32_t> seen;
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        // Sizes that don't divide the capacity, so records wrap.
+        std::size_t bytes = 1 + i % 13;
+        unsigned char *p = ring.reserve(i, bytes);
+        assert(p != nullptr);
+        std::fill(p, p + bytes, (unsigned char)i);
+        ring.commit();
+        ring.consume([&](std::uint32_t tag, const unsigned char *q, std::size_t n) {
+            assert(n >= 1 + tag % 13);
+            for (std::size_t j = 0; j < 1 + tag % 13; ++j) {
+                assert(q[j] == (unsigned char)tag);
+            }
+            seen.push_back(tag);
+        });
+    }
+    assert(seen.size() == 100);
+    assert(ring.empty());
+
+    // Full: records are refused rather than overwritten. Depending on
+    // where the ring wraps, padding may cost one record's worth.
+    int accepted = 0;
+    while (ring.reserve(7, 8) != nullptr) {
+        ring.commit();
+        ++accepted;
+    }
+    assert(accepted == 3 || accepted == 4);
+    assert(ring.reserve(7, 100) == nullptr);
+    assert(ring.consume([](std::uint32_t, const unsigned char *, std::size_t) {}) == std::size_t(accepted));
+}
+
+struct collector {
+    std::mutex m;
+    std::vector<std::string> lines;
+    binary_logger::sink_type sink()
+    {
+        return [this](const std::string& line) {
+            std::lock_guard<std::mutex> lk(m);
+            lines.push_back(line);
+        };
+    }
+};
+
+void format_test()
+{
+    collector out;
+    {
+        binary_logger log(out.sink(), 4096, std::chrono::microseconds(100));
+        auto hello = log.add_format<>("hello");
+        auto order = log.add_format<int, double, const char *>("order %d: %.2f %s");
+        auto big = log.add_format<std::uint64_t, char>("%020llu%c");
+        assert(log.log(hello));
+        assert(log.log(order, 42, 3.14159, "filled"));
+        assert(log.log(order, short(-1), 2.0f, "partial"));  // converted to the format's types
+        assert(log.log(big, 12345ull, 'x'));
+        log.flush();
+        {
+            std::lock_guard<std::mutex> lk(out.m);
+            assert(out.lines.size() == 4);
+            assert(out.lines[0] == "hello");
+            assert(out.lines[1] == "order 42: 3.14 filled");
+            assert(out.lines[2] == "order -1: 2.00 partial");
+            assert(out.lines[3] == "00000000000000012345x");
+        }
+        auto longer = log.add_format<int>("%300d");
+        log.log(longer, 7);
+    }
+    // The destructor formats what's left.
+    assert(out.lines.size() == 5);
+    assert(out.lines[4].size() == 300 && out.lines[4].back() == '7');
+}
+
+void threads_test()
+{
+    collector out;
+    const int threads = 4, per_thread = 20000;
+    std::uint64_t dropped;
+    {
+        binary_logger log(out.sink(), 1024, std::chrono::microseconds(50));
+        auto f = log.add_format<int, int>("%d %d");
+        std::vector<std::thread> ts;
+        for (int k = 0; k < threads; ++k) {
+            ts.emplace_back([&, k] {
+                for (int i = 0; i < per_thread; ++i) {
+                    log.log(f, k, i);
+                }
+            });
+        }
+        for (auto&& t : ts) {
+            t.join();
+        }
+        log.flush();
+        dropped = log.dropped();
+    }
+    // Each thread's records arrive in order; whatever didn't fit was counted.
+    assert(out.lines.size() + dropped == std::size_t(threads * per_thread));
+    std::vector<int> last(threads, -1);
+    for (auto&& line : out.lines) {
+        int k, i;
+        assert(std::sscanf(line.c_str(), "%d %d", &k, &i) == 2);
+        assert(i > last[k]);
+        last[k] = i;
+    }
+}
+
+void several_loggers_test()
+{
+    collector out1, out2, out3;
+    {
+        binary_logger log1(out1.sink()), log2(out2.sink()), log3(out3.sink());
+        auto f1 = log1.add_format<int>("a%d");
+        auto f2 = log2.add_format<int>("b%d");
+        auto f3 = log3.add_format<int>("c%d");
+        log3.attach_thread();
+        // Alternating between loggers keeps each one's records apart and
+        // in order.
+        for (int i = 0; i < 100; ++i) {
+            assert(log1.log(f1, i));
+            assert(log2.log(f2, i));
+            if (i % 10 == 0) {
+                assert(log3.log(f3, i));
+            }
+        }
+    }
+    assert(out1.lines.size() == 100 && out2.lines.size() == 100 && out3.lines.size() == 10);
+    for (int i = 0; i < 100; ++i) {
+        assert(out1.lines[i] == "a" + std::to_string(i));
+        assert(out2.lines[i] == "b" + std::to_string(i));
+    }
+    assert(out3.lines[9] == "c90");
+}
+
+void late_format_test()
+{
+    // A format registered and used while the worker is part way through a
+    // pass is newer than the worker's copy of the table. Hold the worker in
+    // the sink for main's record, and meanwhile have a second thread, whose
+    // ring comes after main's, register a format and log with it.
+    std::mutex m;
+    std::condition_variable cv;
+    bool attached = false, go = false, logged = false;
+    std::vector<std::string> lines;
+    {
+        binary_logger log([&](const std::string& line) {
+            std::unique_lock<std::mutex> lk(m);
+            lines.push_back(line);
+            if (line == "first") {
+                go = true;
+                cv.notify_all();
+                cv.wait(lk, [&] { return logged; });
+            }
+        }, 4096, std::chrono::microseconds(10));
+        auto first = log.add_format<>("first");
+        log.attach_thread();
+        std::thread t([&] {
+            log.attach_thread();
+            std::unique_lock<std::mutex> lk(m);
+            attached = true;
+            cv.notify_all();
+            cv.wait(lk, [&] { return go; });
+            auto late = log.add_format<int>("late %d");
+            assert(log.log(late, 7));
+            logged = true;
+            cv.notify_all();
+        });
+        {
+            std::unique_lock<std::mutex> lk(m);
+            cv.wait(lk, [&] { return attached; });
+        }
+        assert(log.log(first));
+        t.join();
+    }
+    assert((lines == std::vector<std::string>{"first", "late 7"}));
+}
+
+int main()
+{
+    record_ring_test();
+    format_test();
+    threads_test();
+    several_loggers_test();
+    late_format_test();
+}
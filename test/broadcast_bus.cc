@@ -0,0 +1,136 @@
+#include "broadcast_bus.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using std::experimental::broadcast_bus;
+
+struct event {
+    std::uint64_t seq;
+    int payload[3];
+};
+
+void filter_test()
+{
+    broadcast_bus<event, 4> bus(16);
+    auto all = bus.subscribe(~0ull);
+    auto odd = bus.subscribe(0b10);
+    auto none = bus.subscribe(0b1000);
+    for (std::uint64_t i = 0; i < 12; ++i) {
+        bus.publish(i % 2 ? 0b10 : 0b01, event{i, {int(i), 0, 0}});
+    }
+    assert(bus.published() == 12);
+
+    event e;
+    std::uint64_t topics;
+    for (std::uint64_t i = 0; i < 12; ++i) {
+        assert(all.try_receive(e, &topics));
+        assert(e.seq == i && e.payload[0] == int(i));
+        assert(topics == (i % 2 ? 0b10u : 0b01u));
+    }
+    assert(not all.try_receive(e));
+    for (std::uint64_t i = 1; i < 12; i += 2) {
+        assert(odd.lag() != 0);
+        assert(odd.try_receive(e));
+        assert(e.seq == i);
+    }
+    assert(not odd.try_receive(e));
+    assert(odd.lag() == 0);
+    assert(not none.try_receive(e));
+    assert(none.lag() == 0 && none.dropped() == 0);
+
+    // Late subscribers only see what's published after they subscribe.
+    auto late = bus.subscribe(~0ull);
+    assert(not late.try_receive(e));
+    bus.publish(0b100, event{99, {}});
+    assert(late.try_receive(e) && e.seq == 99);
+    assert(not odd.try_receive(e));
+}
+
+void block_skip_test()
+{
+    // Rare topics, in otherwise uninteresting blocks.
+    broadcast_bus<std::uint64_t, 8> bus(64);
+    auto rare = bus.subscribe(0b10);
+    std::uint64_t v;
+    for (std::uint64_t i = 0; i < 60; ++i) {
+        bus.publish(i == 37 ? 0b10 : 0b01, i);
+    }
+    assert(rare.try_receive(v) && v == 37);
+    assert(not rare.try_receive(v));
+    assert(rare.lag() == 0 && rare.dropped() == 0);
+}
+
+void lapping_test()
+{
+    broadcast_bus<std::uint64_t, 4> bus(8);
+    auto slow = bus.subscribe(~0ull);
+    for (std::uint64_t i = 0; i < 20; ++i) {
+        bus.publish(1, i);
+    }
+    assert(slow.lag() == 20);
+    std::uint64_t v;
+    // Only the last ring's worth survives.
+    for (std::uint64_t i = 12; i < 20; ++i) {
+        assert(slow.try_receive(v));
+        assert(v == i);
+    }
+    assert(slow.dropped() == 12);
+    assert(not slow.try_receive(v));
+}
+
+void concurrent_test()
+{
+    const std::uint64_t n = 200000;
+    broadcast_bus<event, 16> bus(1024);
+    std::atomic<int> ready(0);
+    std::vector<std::thread> threads;
+    std::vector<std::uint64_t> received(3), dropped(3);
+    for (int k = 0; k < 3; ++k) {
+        threads.emplace_back([&, k] {
+            auto sub = bus.subscribe(k == 0 ? ~0ull : (1ull << k));
+            ++ready;
+            std::uint64_t last = 0;
+            bool first = true;
+            event e;
+            while (last + 1 < n || first) {
+                if (not sub.try_receive(e)) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                assert(first || e.seq > last);
+                assert(e.payload[0] == int(e.seq) && e.payload[2] == -int(e.seq));
+                assert(k == 0 || e.seq % 3 == std::uint64_t(k));
+                last = e.seq;
+                first = false;
+                ++received[k];
+                if (k != 0 && last + 3 >= n) {
+                    break;
+                }
+            }
+            dropped[k] = sub.dropped();
+        });
+    }
+    while (ready != 3) {
+        std::this_thread::yield();
+    }
+    for (std::uint64_t i = 0; i < n; ++i) {
+        bus.publish(1ull << (i % 3), event{i, {int(i), 7, -int(i)}});
+    }
+    for (auto&& t : threads) {
+        t.join();
+    }
+    // Everything is either received or counted as dropped.
+    assert(received[0] + dropped[0] == n);
+}
+
+int main()
+{
+    filter_test();
+    block_skip_test();
+    lapping_test();
+    concurrent_test();
+}
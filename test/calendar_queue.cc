@@ -0,0 +1,127 @@
+#include "calendar_queue.h"
+
+#include <cassert>
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using std::experimental::calendar_queue;
+
+void basic_test()
+{
+    calendar_queue<int> q;
+    assert(q.empty());
+    for (int i : { 5, 3, 9, 1, 7, 3 }) {
+        q.push(i);
+    }
+    assert(q.size() == 6);
+    for (int i : { 1, 3, 3, 5, 7, 9 }) {
+        assert(q.top() == i);
+        q.pop();
+    }
+    assert(q.empty());
+}
+
+struct event {
+    double time;
+    int id;
+};
+
+struct time_of {
+    double operator()(const event& e) const { return e.time; }
+};
+
+void hold_model_test()
+{
+    // The classic "hold" benchmark: pop the earliest event, then schedule
+    // a new one a random interval later. Compare against a priority_queue
+    // ordered by (time, id), which also checks FIFO order for equal times.
+    auto later = [](const event& a, const event& b) {
+        return (a.time != b.time) ? (a.time > b.time) : (a.id > b.id);
+    };
+    std::priority_queue<event, std::vector<event>, decltype(later)> model(later);
+    calendar_queue<event, time_of> q;
+
+    std::mt19937 g(5);
+    std::exponential_distribution<double> interval(1.0);
+    int next_id = 0;
+    for (int i = 0; i < 5000; ++i) {
+        event e{ double(int(interval(g) * 100)) / 10, next_id++ };
+        q.push(e);
+        model.push(e);
+    }
+    assert(q.buckets() >= 2048);
+    double now = 0;
+    for (int i = 0; i < 50000; ++i) {
+        assert(q.top().id == model.top().id);
+        now = q.top().time;
+        q.pop();
+        model.pop();
+        event e{ now + double(int(interval(g) * 100)) / 10, next_id++ };
+        q.push(e);
+        model.push(e);
+    }
+    // Drain; the queue shrinks as it goes.
+    while (not model.empty()) {
+        assert(q.top().id == model.top().id);
+        q.pop();
+        model.pop();
+    }
+    assert(q.empty());
+    assert(q.buckets() <= 4);
+}
+
+void out_of_order_test()
+{
+    // Events scheduled earlier than the current position are still found.
+    calendar_queue<std::uint64_t> q;
+    for (std::uint64_t t = 1000; t < 1100; ++t) {
+        q.push(t);
+    }
+    assert(q.top() == 1000);
+    q.pop();
+    q.push(3);
+    assert(q.top() == 3);
+    q.pop();
+    q.push(1000000);
+    for (std::uint64_t t = 1001; t < 1100; ++t) {
+        assert(q.top() == t);
+        q.pop();
+    }
+    assert(q.top() == 1000000);
+}
+
+struct named_event {
+    double time;
+    std::string name;
+};
+
+struct named_time_of {
+    double operator()(const named_event& e) const { return e.time; }
+};
+
+void string_payload_test()
+{
+    // Many equal times pile into one bucket, which grows by moving its
+    // (not trivially relocatable) events over.
+    calendar_queue<named_event, named_time_of> q;
+    for (int i = 0; i < 50; ++i) {
+        q.push(named_event{1.0, std::string(30, 'a') + std::to_string(i)});
+    }
+    for (int i = 0; i < 50; ++i) {
+        assert(q.top().name == std::string(30, 'a') + std::to_string(i));
+        q.pop();
+    }
+    assert(q.empty());
+}
+
+int main()
+{
+    basic_test();
+    hold_model_test();
+    out_of_order_test();
+    string_payload_test();
+}
@@ -0,0 +1,83 @@
+#include "ring_span.h"
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+using std::experimental::ring_span;
+
+void basic_test()
+{
+    std::vector<int> buffer(8);
+    // Start near the end of the buffer, so the contents wrap.
+    ring_span<int> r(buffer.begin(), buffer.end(), buffer.begin() + 6, 0);
+    for (int i = 0; i < 6; ++i) {
+        r.push_back(i);
+    }
+    std::vector<int> seen;
+    r.consume_front(4, [&](int& x) { seen.push_back(x); });
+    assert((seen == std::vector<int>{0, 1, 2, 3}));
+    assert(r.size() == 2);
+    assert(r.front() == 4 && r.back() == 5);
+
+    // Consuming nothing is a no-op.
+    r.consume_front(0, [](int&) { assert(false); });
+    assert(r.size() == 2 && r.front() == 4);
+
+    r.push_back(6);
+    r.consume_front(3, [&](int& x) { seen.push_back(x); });
+    assert(r.empty());
+    assert((seen == std::vector<int>{0, 1, 2, 3, 4, 5, 6}));
+}
+
+void equivalence_test()
+{
+    // consume_front(n) sees the same elements as n pop_front()s.
+    std::vector<int> b1(13), b2(13);
+    ring_span<int> r1(b1.begin(), b1.end(), b1.begin(), 0);
+    ring_span<int> r2(b2.begin(), b2.end(), b2.begin(), 0);
+    int next = 0;
+    // Unsigned, so the hashes wrap instead of overflowing.
+    std::uint64_t sum1 = 0, sum2 = 0;
+    for (int round = 0; round < 200; ++round) {
+        for (int i = 0; i < 1 + round % 11; ++i, ++next) {
+            r1.push_back(next);
+            r2.push_back(next);
+        }
+        std::size_t n = r1.size() / 2 + round % 2;
+        r1.consume_front(n, [&](int& x) { sum1 = sum1 * 31 + x; });
+        for (std::size_t i = 0; i < n; ++i) {
+            sum2 = sum2 * 31 + r2.pop_front();
+        }
+        assert(sum1 == sum2);
+        assert(r1.size() == r2.size());
+        assert(r1.empty() || r1.front() == r2.front());
+    }
+}
+
+void in_place_test()
+{
+    // Elements are visited by reference and not moved out: f may take
+    // ownership itself, and anything it leaves stays in the buffer.
+    std::vector<std::unique_ptr<std::string>> buffer(4);
+    ring_span<std::unique_ptr<std::string>> r(buffer.begin(), buffer.end(), buffer.begin(), 0);
+    for (const char *s : { "a", "b", "c" }) {
+        r.push_back(std::make_unique<std::string>(s));
+    }
+    std::string joined;
+    r.consume_front(2, [&](std::unique_ptr<std::string>& p) { joined += *p; });
+    assert(joined == "ab");
+    assert(buffer[0] && *buffer[0] == "a");
+    assert(buffer[1] && *buffer[1] == "b");
+    assert(r.size() == 1 && *r.front() == "c");
+}
+
+int main()
+{
+    basic_test();
+    equivalence_test();
+    in_place_test();
+}
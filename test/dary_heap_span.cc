@@ -0,0 +1,73 @@
+#include "dary_heap_span.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+using std::experimental::dary_heap_span;
+
+template<class T, std::size_t Arity, class Comparator = std::less<>>
+void heapsort_test(int n, unsigned seed)
+{
+    std::mt19937 g(seed);
+    std::vector<T> input(n);
+    for (auto&& x : input) {
+        // Plenty of duplicates, so ties among children get exercised.
+        x = T(int(g() % 1000) - 300);
+    }
+    std::vector<T> expected = input;
+    std::sort(expected.begin(), expected.end(), Comparator());
+
+    // One element at a time.
+    std::vector<T> buffer(n);
+    dary_heap_span<T, Arity, Comparator> h(buffer.begin(), buffer.end(), 0);
+    for (auto&& x : input) {
+        h.push(x);
+    }
+    for (auto&& x : expected) {
+        assert(h.top() == x);
+        h.pop();
+    }
+    assert(h.empty());
+
+    // All at once.
+    buffer = input;
+    dary_heap_span<T, Arity, Comparator> h2(buffer.begin(), buffer.end());
+    h2.make_heap();
+    for (auto&& x : expected) {
+        assert(h2.top() == x);
+        h2.pop();
+    }
+}
+
+void full_test()
+{
+    // As with heap_span, pushing into a full heap replaces the top.
+    std::vector<int> buffer(3);
+    dary_heap_span<int> h(buffer.begin(), buffer.end(), 0);
+    h.push(2);
+    h.push(5);
+    h.push(4);
+    h.push(3);
+    assert(h.size() == 3);
+    assert(h.top() == 3);
+}
+
+int main()
+{
+    for (int n : { 1, 7, 8, 9, 64, 65, 1000, 5000 }) {
+        heapsort_test<std::int32_t, 8>(n, n);
+        heapsort_test<std::int32_t, 16>(n, n);
+        heapsort_test<std::uint32_t, 8>(n, n);
+        heapsort_test<float, 8>(n, n);
+        heapsort_test<float, 16>(n, n);
+        heapsort_test<double, 8>(n, n);
+        heapsort_test<std::int32_t, 4>(n, n);
+        heapsort_test<std::int32_t, 2>(n, n);
+        heapsort_test<std::int32_t, 8, std::greater<>>(n, n);
+    }
+    full_test();
+}
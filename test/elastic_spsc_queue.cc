@@ -0,0 +1,88 @@
+#include "elastic_spsc_queue.h"
+
+#include <cassert>
+#include <memory>
+#include <thread>
+
+using std::experimental::elastic_spsc_queue;
+
+void basic_test()
+{
+    elastic_spsc_queue<int> q(3);
+    assert(q.capacity() == 4);
+    int v;
+    assert(not q.try_pop(v));
+
+    // Wrap around the first segment a few times without growing.
+    int next = 0, expected = 0;
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 3; ++i) {
+            q.push(next++);
+        }
+        for (int i = 0; i < 3; ++i) {
+            assert(q.try_pop(v) && v == expected++);
+        }
+    }
+    assert(q.capacity() == 4 && q.segments() == 1);
+
+    // Overfill: the queue grows to 8, then 16, keeping FIFO order.
+    for (int i = 0; i < 20; ++i) {
+        q.push(next++);
+    }
+    assert(q.capacity() == 16);
+    assert(q.segments() == 3);
+    for (int i = 0; i < 20; ++i) {
+        assert(q.try_pop(v) && v == expected++);
+    }
+    assert(not q.try_pop(v));
+    // The drained segments have been freed.
+    assert(q.segments() == 1);
+}
+
+void moveonly_test()
+{
+    elastic_spsc_queue<std::unique_ptr<int>> q(2);
+    for (int i = 0; i < 100; ++i) {
+        q.push(std::make_unique<int>(i));
+    }
+    std::unique_ptr<int> p;
+    for (int i = 0; i < 50; ++i) {
+        assert(q.try_pop(p) && *p == i);
+    }
+    // The rest are freed by the destructor.
+}
+
+void threads_test()
+{
+    // Bursts much larger than the initial capacity, so the queue grows
+    // while the consumer is reading.
+    const int n = 500000;
+    elastic_spsc_queue<std::unique_ptr<int>> q(16);
+    std::thread producer([&] {
+        for (int i = 0; i < n; ++i) {
+            q.push(std::make_unique<int>(i));
+            if (i % 10000 == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::unique_ptr<int> p;
+    for (int expected = 0; expected < n; ) {
+        if (q.try_pop(p)) {
+            assert(*p == expected);
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    assert(not q.try_pop(p));
+    assert(q.segments() == 1);
+}
+
+int main()
+{
+    basic_test();
+    moveonly_test();
+    threads_test();
+}
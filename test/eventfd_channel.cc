@@ -0,0 +1,101 @@
+#include "eventfd_channel.h"
+
+#include <cassert>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+using std::experimental::eventfd_channel;
+
+bool readable(int fd)
+{
+    pollfd p = { fd, POLLIN, 0 };
+    return ::poll(&p, 1, 0) == 1;
+}
+
+void signal_test()
+{
+    std::vector<std::unique_ptr<int>> buffer(4);
+    eventfd_channel<std::unique_ptr<int>> ch(buffer.begin(), buffer.end());
+    assert(not readable(ch.fd()));
+
+    // Only the first push after arming writes to the eventfd.
+    for (int i = 0; i < 4; ++i) {
+        assert(ch.try_push(std::make_unique<int>(i)));
+    }
+    assert(not ch.try_push(std::make_unique<int>(4)));
+    assert(ch.signals() == 1);
+    assert(readable(ch.fd()));
+
+    std::unique_ptr<int> p;
+    for (int i = 0; i < 4; ++i) {
+        assert(ch.try_pop(p) && *p == i);
+    }
+    assert(not ch.try_pop(p));
+    assert(ch.rearm());
+    assert(ch.clears() == 1);
+    assert(not readable(ch.fd()));
+
+    // Rearming again with no signal in between makes no system call.
+    assert(ch.rearm());
+    assert(ch.clears() == 1);
+
+    // Something pushed after draining but before rearming is reported.
+    assert(ch.try_push(std::make_unique<int>(5)));
+    assert(ch.signals() == 2);
+    assert(not ch.rearm());
+    assert(ch.try_pop(p) && *p == 5);
+    assert(ch.rearm());
+    assert(not readable(ch.fd()));
+}
+
+void epoll_test()
+{
+    const int n = 100000;
+    std::vector<int> buffer(256);
+    eventfd_channel<int> ch(buffer.begin(), buffer.end());
+    int ep = ::epoll_create1(0);
+    assert(ep >= 0);
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    assert(::epoll_ctl(ep, EPOLL_CTL_ADD, ch.fd(), &ev) == 0);
+
+    std::thread producer([&] {
+        for (int i = 0; i < n; ++i) {
+            while (not ch.try_push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    int expected = 0, waits = 0;
+    while (expected < n) {
+        epoll_event out;
+        int r = ::epoll_wait(ep, &out, 1, 1000);
+        assert(r == 1);
+        ++waits;
+        do {
+            int v;
+            while (ch.try_pop(v)) {
+                assert(v == expected);
+                ++expected;
+            }
+        } while (not ch.rearm());
+    }
+    producer.join();
+    ::close(ep);
+    // At most one eventfd write per message (in practice far fewer), and
+    // at most two wakeups and two reads per write.
+    assert(ch.signals() <= std::uint64_t(n));
+    assert(std::uint64_t(waits) <= 2 * ch.signals());
+    assert(ch.clears() <= 2 * ch.signals());
+}
+
+int main()
+{
+    signal_test();
+    epoll_test();
+}
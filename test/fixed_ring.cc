@@ -0,0 +1,123 @@
+#include "fixed_ring.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+// The bookkeeping is two indices of the smallest type that fits Capacity.
+static_assert(sizeof(fixed_ring<std::uint8_t, 16>) == 16 + 2, "");
+static_assert(sizeof(fixed_ring<std::uint8_t, 255>) == 255 + 2, "");
+static_assert(sizeof(fixed_ring<std::uint16_t, 256>) == 512 + 4, "");
+static_assert(sizeof(fixed_ring<std::uint32_t, 1000>) == 4000 + 4, "");
+
+// No pointers into itself, so trivially copyable T makes a trivially copyable ring.
+static_assert(std::is_trivially_copyable<fixed_ring<int, 8>>::value, "");
+static_assert(std::is_trivially_copyable<fixed_ring<double, 1000>>::value, "");
+static_assert(std::is_standard_layout<fixed_ring<int, 8>>::value, "");
+static_assert(not std::is_trivially_copyable<fixed_ring<std::string, 8>>::value, "");
+
+void basic_test()
+{
+    fixed_ring<int, 4> fr;
+    assert(fr.size() == 0);
+    assert(fr.empty());
+    fr.push(1);
+    assert(fr.size() == 1); assert(fr.front() == 1); assert(fr.back() == 1);
+    fr.push(2);
+    assert(fr.size() == 2); assert(fr.front() == 1); assert(fr.back() == 2);
+    fr.push(3);
+    assert(fr.size() == 3); assert(fr.front() == 1); assert(fr.back() == 3);
+    fr.push(4);
+    assert(fr.size() == 4); assert(fr.front() == 1); assert(fr.back() == 4);
+    assert(not fr.try_push(9));
+    fr.push(5);
+    assert(fr.size() == 4); assert(fr.front() == 2); assert(fr.back() == 5);
+    fr.push(6);
+    assert(fr.size() == 4); assert(fr.front() == 3); assert(fr.back() == 6);
+    fr.pop();
+    assert(fr.size() == 3); assert(fr.front() == 4); assert(fr.back() == 6);
+    assert(fr.try_emplace(7));
+    assert(fr.size() == 4); assert(fr.back() == 7);
+}
+
+void wrap_test()
+{
+    // Go round a 255-element ring (the largest with uint8_t indices) a few times.
+    fixed_ring<std::uint8_t, 255> fr;
+    unsigned next = 0, expected = 0;
+    for (int round = 0; round < 1000; ++round) {
+        for (int i = 0; i < 7; ++i) {
+            fr.emplace(std::uint8_t(next++));
+            if (fr.size() == fr.capacity() && next - expected > fr.capacity()) {
+                ++expected;  // overwritten
+            }
+        }
+        for (int i = 0; i < 5 && not fr.empty(); ++i) {
+            assert(fr.front() == std::uint8_t(expected));
+            fr.pop();
+            ++expected;
+        }
+        assert(fr.back() == std::uint8_t(next - 1));
+        assert(fr.size() == next - expected);
+    }
+}
+
+void copy_move_test()
+{
+    fixed_ring<std::string, 3> a;
+    for (const char *s : { "one", "two", "three", "four" }) {
+        a.push(s);
+    }
+    fixed_ring<std::string, 3> b = a;
+    assert(b.size() == 3 && b.front() == "two" && b.back() == "four");
+    fixed_ring<std::string, 3> c = std::move(b);
+    assert(c.size() == 3 && c.front() == "two" && c.back() == "four");
+    fixed_ring<std::string, 3> d;
+    d.push("x");
+    d.swap(c);
+    assert(d.size() == 3 && d.front() == "two");
+    assert(c.size() == 1 && c.front() == "x");
+
+    fixed_ring<std::unique_ptr<int>, 2> p;
+    p.push(std::make_unique<int>(1));
+    p.emplace(new int(2));
+    assert(*p.front() == 1 && *p.back() == 2);
+    p.pop();
+    assert(p.size() == 1 && *p.front() == 2);
+}
+
+void memcpy_test()
+{
+    fixed_ring<int, 5> a;
+    for (int i = 0; i < 8; ++i) {
+        a.push(i);
+    }
+    a.pop();
+
+    // A byte copy, as if through shared memory, is a working ring.
+    alignas(fixed_ring<int, 5>) unsigned char bytes[sizeof a];
+    std::memcpy(bytes, &a, sizeof a);
+    fixed_ring<int, 5> b;
+    std::memcpy(&b, bytes, sizeof b);
+    for (int i = 4; i < 8; ++i) {
+        assert(b.front() == i);
+        b.pop();
+    }
+    assert(b.empty());
+    b.push(42);
+    assert(b.front() == 42 && b.back() == 42);
+
+    // The original is unaffected.
+    assert(a.size() == 4 && a.front() == 4 && a.back() == 7);
+}
+
+int main()
+{
+    basic_test();
+    wrap_test();
+    copy_move_test();
+    memcpy_test();
+}
@@ -0,0 +1,181 @@
+#include "heap_span.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using std::experimental::heap_span;
+
+void basic_test()
+{
+    std::vector<int> buffer(4);
+    heap_span<int> h(buffer.begin(), buffer.end(), 0);
+    h.push(5);
+    h.push(3);
+    h.push(8);
+    assert(h.size() == 3);
+    assert(h.top() == 3);
+    h.push(1);
+    assert(h.full());
+    assert(h.top() == 1);
+    h.pop();
+    assert(h.top() == 3);
+    h.pop();
+    assert(h.top() == 5);
+    h.pop();
+    assert(h.top() == 8);
+    h.pop();
+    assert(h.empty());
+}
+
+void pop_order_test()
+{
+    // Lots of duplicates, so ties between siblings get exercised.
+    std::mt19937 g(7);
+    std::vector<int> input(5000);
+    for (auto&& x : input) {
+        x = int(g() % 100);
+    }
+    std::vector<int> expected = input;
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<int> buffer(input.size());
+    heap_span<int> h(buffer.begin(), buffer.end(), 0);
+    for (int x : input) {
+        h.push(x);
+    }
+    for (int x : expected) {
+        assert(h.top() == x);
+        h.pop();
+    }
+    assert(h.empty());
+}
+
+void string_test()
+{
+    std::mt19937 g(11);
+    std::vector<std::string> input(2000);
+    for (auto&& x : input) {
+        // Long enough to defeat the small-string optimization.
+        x = std::string(40, 'x') + std::to_string(g() % 500);
+    }
+    std::vector<std::string> expected = input;
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<std::string> buffer(input.size());
+    heap_span<std::string> h(buffer.begin(), buffer.end(), 0);
+    for (auto&& x : input) {
+        h.push(x);
+    }
+    for (auto&& x : expected) {
+        assert(h.top() == x);
+        h.pop();
+    }
+}
+
+void moveonly_test()
+{
+    using ptr = std::unique_ptr<int>;
+    auto less = [](const ptr& a, const ptr& b) { return *a < *b; };
+    std::vector<ptr> buffer(5);
+    heap_span<ptr, decltype(less)> h(buffer.begin(), buffer.end(), 0, less);
+    for (int i : { 4, 2, 5, 1, 3 }) {
+        h.push(std::make_unique<int>(i));
+    }
+    for (int i = 1; i <= 5; ++i) {
+        assert(*h.top() == i);
+        h.pop();
+    }
+}
+
+struct counted {
+    static int moves, copies, constructions;
+    int v = 0;
+    counted() = default;
+    explicit counted(int i) : v(i) {}
+    counted(const counted& o) : v(o.v) { ++copies; ++constructions; }
+    counted(counted&& o) : v(o.v) { ++moves; ++constructions; }
+    counted& operator=(const counted& o) { v = o.v; ++copies; return *this; }
+    counted& operator=(counted&& o) { v = o.v; ++moves; return *this; }
+    bool operator<(const counted& o) const { return v < o.v; }
+};
+int counted::moves, counted::copies, counted::constructions;
+
+void move_count_test()
+{
+    // A push that doesn't need to sift costs exactly one assignment.
+    std::vector<counted> buffer(1000);
+    heap_span<counted> h(buffer.begin(), buffer.end(), 0);
+    counted::moves = counted::copies = counted::constructions = 0;
+    for (int i = 0; i < 1000; ++i) {
+        h.push(counted(i));
+    }
+    assert(counted::moves == 1000 && counted::copies == 0 && counted::constructions == 0);
+
+    h = heap_span<counted>(buffer.begin(), buffer.end(), 0);
+    const counted c(5);
+    counted::moves = counted::copies = counted::constructions = 0;
+    h.push(c);
+    assert(counted::copies == 1 && counted::moves == 0);
+
+    counted::moves = counted::copies = counted::constructions = 0;
+    h.emplace(7);
+    assert(counted::moves == 1 && counted::copies == 0);
+    assert(h.top().v == 5);
+}
+
+void make_heap_test(unsigned nthreads)
+{
+    std::mt19937 g(nthreads);
+    for (std::size_t n : { 0, 1, 2, 3, 100, 65535, 300000 }) {
+        std::vector<int> v(n);
+        for (auto&& x : v) {
+            x = int(g() % 1000000);
+        }
+        // Not v.begin(): dereferencing it is undefined when v is empty.
+        heap_span<int> h(v.data(), v.data() + v.size());
+        if (nthreads == 0) {
+            h.make_heap();
+        } else {
+            h.make_heap(nthreads);
+        }
+        assert(std::is_heap(v.begin(), v.end(), std::greater<>()));
+        if (n != 0) {
+            assert(h.top() == *std::min_element(v.begin(), v.end()));
+        }
+    }
+}
+
+void parallel_sort_test()
+{
+    std::mt19937 g(42);
+    for (unsigned nthreads : { 1, 2, 3, 4, 7 }) {
+        std::vector<int> v(200000);
+        for (auto&& x : v) {
+            x = int(g());
+        }
+        heap_span<int> h(v.begin(), v.end());
+        h.sort(nthreads);
+        assert(std::is_sorted(v.begin(), v.end()));
+        // A sorted array is also a valid heap.
+        assert(std::is_heap(v.begin(), v.end(), std::greater<>()));
+    }
+}
+
+int main()
+{
+    basic_test();
+    pop_order_test();
+    string_test();
+    moveonly_test();
+    move_count_test();
+    make_heap_test(0);
+    make_heap_test(2);
+    make_heap_test(4);
+    make_heap_test(5);
+    parallel_sort_test();
+}
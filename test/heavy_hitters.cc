@@ -0,0 +1,96 @@
+#include "heavy_hitters.h"
+
+#include <cassert>
+#include <deque>
+#include <map>
+#include <random>
+#include <string>
+
+using std::experimental::window_heavy_hitters;
+
+void exact_test()
+{
+    window_heavy_hitters<std::string> hh(5);
+    for (const char *k : { "a", "b", "a", "c", "a" }) {
+        hh.push(k);
+    }
+    auto top = hh.top_k(2);
+    assert(top.size() == 2);
+    assert(top[0].key == "a" && top[0].count == 3);
+    assert(top[1].count == 1);
+
+    // Push "b" three times; the three oldest entries ("a", "b", "a") leave.
+    hh.push("b");
+    hh.push("b");
+    hh.push("b");
+    assert(hh.count("a") == 1);
+    assert(hh.count("b") == 3);
+    assert(hh.count("c") == 1);
+    top = hh.top_k(10);
+    assert(top.size() == 3);
+    assert(top[0].key == "b" && top[0].count == 3);
+    assert(top[1].count == 1 && top[2].count == 1);
+
+    hh.push("d"); hh.push("d"); hh.push("d"); hh.push("d"); hh.push("d");
+    assert(hh.tracked() == 1);
+    assert(hh.count("b") == 0);
+    assert(hh.top_k(3).size() == 1);
+}
+
+void exact_matches_recount_test()
+{
+    const std::size_t window = 200;
+    window_heavy_hitters<int> hh(window);
+    std::deque<int> recent;
+    std::mt19937 g(42);
+    std::geometric_distribution<int> dist(0.1);
+    for (int i = 0; i < 5000; ++i) {
+        int k = dist(g);
+        hh.push(k);
+        recent.push_back(k);
+        if (recent.size() > window) {
+            recent.pop_front();
+        }
+        if (i % 250 == 0) {
+            std::map<int, std::size_t> counts;
+            for (int r : recent) {
+                ++counts[r];
+            }
+            auto top = hh.top_k(5);
+            assert(top.size() == std::min<std::size_t>(5, counts.size()));
+            for (std::size_t j = 0; j < top.size(); ++j) {
+                assert(top[j].count == counts[top[j].key]);
+                if (j != 0) {
+                    assert(top[j - 1].count >= top[j].count);
+                }
+            }
+            for (auto&& kv : counts) {
+                assert(kv.second <= top[0].count);
+            }
+        }
+    }
+}
+
+void space_saving_test()
+{
+    // Three counters for a window of 100 keys drawn from one heavy key
+    // and many light ones. The heavy key must be reported first and its
+    // count must be an upper bound within the reported error.
+    window_heavy_hitters<int> hh(100, 3);
+    for (int i = 0; i < 1000; ++i) {
+        hh.push((i % 2 == 0) ? 7 : i);
+    }
+    assert(hh.tracked() == 3);
+    auto top = hh.top_k(1);
+    assert(top.size() == 1);
+    assert(top[0].key == 7);
+    assert(top[0].count >= 50);
+    assert(top[0].count - top[0].error <= 50);
+}
+
+int main()
+{
+    exact_test();
+    exact_matches_recount_test();
+    space_saving_test();
+}
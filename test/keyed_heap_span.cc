@@ -0,0 +1,88 @@
+#include "keyed_heap_span.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <vector>
+
+using std::experimental::keyed_heap_span;
+
+struct job {
+    std::uint64_t deadline;
+    char payload[120];
+};
+
+struct deadline_of {
+    std::uint64_t operator()(const job& j) const { return j.deadline; }
+};
+
+using job_heap = keyed_heap_span<job, deadline_of>;
+
+job make_job(std::uint64_t deadline)
+{
+    job j;
+    j.deadline = deadline;
+    std::fill(std::begin(j.payload), std::end(j.payload), char(deadline));
+    return j;
+}
+
+void ordering_test()
+{
+    std::vector<job> jobs(1000);
+    std::vector<job_heap::entry_type> entries(1000);
+    job_heap h(jobs.begin(), jobs.end(), entries.begin(), entries.end());
+
+    std::mt19937 g(1);
+    std::multiset<std::uint64_t> expected;
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 40; ++i) {
+            std::uint64_t d = g() % 500;
+            h.push(make_job(d));
+            expected.insert(d);
+        }
+        for (int i = 0; i < 30; ++i) {
+            assert(h.top_key() == *expected.begin());
+            assert(h.top().deadline == h.top_key());
+            assert(h.top().payload[119] == char(h.top_key()));
+            expected.erase(expected.begin());
+            h.pop();
+        }
+        assert(h.size() == expected.size());
+    }
+    while (not h.empty()) {
+        assert(h.top().deadline == *expected.begin());
+        expected.erase(expected.begin());
+        h.pop();
+    }
+}
+
+void full_test()
+{
+    // As with heap_span, pushing into a full heap replaces the top.
+    std::vector<job> jobs(3);
+    std::vector<job_heap::entry_type> entries(3);
+    keyed_heap_span<job, deadline_of, std::greater<>> h(jobs.begin(), jobs.end(), entries.begin(), entries.end());
+    h.push(make_job(1));
+    h.push(make_job(5));
+    h.push(make_job(3));
+    assert(h.full());
+    assert(h.top().deadline == 5);
+    h.push(make_job(2));
+    assert(h.size() == 3);
+    assert(h.top().deadline == 3);
+    h.pop();
+    assert(h.top().deadline == 2);
+    h.push(make_job(4));
+    assert(h.top().deadline == 4);
+    h.pop();
+    h.pop();
+    assert(h.top().deadline == 1);
+}
+
+int main()
+{
+    ordering_test();
+    full_test();
+}
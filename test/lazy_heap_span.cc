@@ -0,0 +1,149 @@
+#include "lazy_heap_span.h"
+
+#include <cassert>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+using std::experimental::lazy_heap_span;
+
+using heap = lazy_heap_span<int>;
+
+void basic_test()
+{
+    std::vector<heap::entry_type> buffer(10);
+    heap h(buffer.begin(), buffer.end());
+    auto h5 = h.push(5);
+    auto h1 = h.push(1);
+    h.push(3);
+    assert(h.size() == 3);
+    assert(h.top() == 1);
+    h.erase(h1);
+    assert(h.size() == 2);
+    assert(h.top() == 3);
+    h.erase(h5);
+    assert(h.size() == 1);
+    assert(h.top() == 3);
+    h.pop();
+    assert(h.empty());
+}
+
+void compaction_test()
+{
+    // Cancel 90% of everything pushed; compaction keeps the heap from
+    // filling up with tombstones.
+    std::vector<heap::entry_type> buffer(200);
+    heap h(buffer.begin(), buffer.end(), std::less<>(), 0.5);
+    std::mt19937 g(3);
+    std::set<std::pair<int, heap::handle_type>> live;
+    for (int i = 0; i < 20000; ++i) {
+        int v = int(g() % 100000);
+        auto handle = h.push(v);
+        live.emplace(v, handle);
+        if (g() % 10 != 0) {
+            h.erase(handle);
+            live.erase(std::make_pair(v, handle));
+        }
+        // With a threshold of 0.5, at most half of the stored entries are dead.
+        assert(h.tombstones() <= h.size());
+        if (live.size() > 100) {
+            assert(h.top() == live.begin()->first);
+            h.pop();
+            live.erase(live.begin());
+        }
+        assert(h.size() == live.size());
+    }
+    // Erase a few from the middle of the heap, then drain.
+    for (int i = 0; i < 10; ++i) {
+        auto it = std::next(live.begin(), live.size() / 2);
+        h.erase(it->second);
+        live.erase(it);
+    }
+    while (not live.empty()) {
+        assert(h.top() == live.begin()->first);
+        h.pop();
+        live.erase(live.begin());
+    }
+    assert(h.empty());
+}
+
+void full_test()
+{
+    std::vector<heap::entry_type> buffer(3);
+    heap h(buffer.begin(), buffer.end(), std::less<>(), 10.0);
+    h.push(1);
+    auto h2 = h.push(2);
+    h.push(3);
+    assert(h.full());
+    h.erase(h2);
+    assert(not h.full());
+    // The tombstone makes room; nothing live is replaced.
+    h.push(4);
+    assert(h.size() == 3);
+    assert(h.tombstones() == 0);
+    assert(h.top() == 1);
+
+    // Full of live elements: the push is refused, and every handle stays valid.
+    assert(h.full());
+    assert(h.push(0) == heap::no_handle);
+    assert(h.size() == 3 && h.top() == 1);
+}
+
+void refused_push_test()
+{
+    // A refused push must not displace an element whose handle is still in use.
+    std::vector<heap::entry_type> buffer(2);
+    heap h(buffer.begin(), buffer.end());
+    auto a = h.push(1);
+    h.push(2);
+    assert(h.push(3) == heap::no_handle);
+    h.erase(a);
+    h.pop();
+    assert(h.empty());
+    assert(h.tombstones() == 0);
+    h.compact();
+    assert(h.push(5) != heap::no_handle);
+    assert(h.size() == 1 && h.top() == 5);
+}
+
+void cancel_after_pop_test()
+{
+    // A scheduler's cancel can arrive after the job was dispatched, or
+    // twice; neither touches the heap.
+    std::vector<heap::entry_type> buffer(8);
+    heap h(buffer.begin(), buffer.end());
+    auto a = h.push(1);
+    auto b = h.push(2);
+    auto c = h.push(3);
+    h.pop();
+    assert(not h.erase(a));
+    assert(h.size() == 2 && h.tombstones() == 0);
+    assert(h.erase(c));
+    assert(not h.erase(c));
+    assert(h.size() == 1 && h.tombstones() == 1);
+    assert(not h.erase(heap::no_handle));
+    assert(h.top() == 2);
+    h.pop();
+    assert(h.empty());
+    assert(not h.erase(b));
+    assert(not h.erase(c));
+    assert(h.size() == 0);
+
+    // Likewise once compaction has removed the element.
+    auto d = h.push(4);
+    h.push(5);
+    assert(h.erase(d));
+    h.compact();
+    assert(not h.erase(d));
+    assert(h.size() == 1 && h.top() == 5);
+}
+
+int main()
+{
+    basic_test();
+    compaction_test();
+    full_test();
+    refused_push_test();
+    cancel_after_pop_test();
+}
@@ -0,0 +1,173 @@
+#include "pairing_heap.h"
+
+#include <cassert>
+#include <climits>
+#include <functional>
+#include <queue>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+using std::experimental::pairing_heap;
+using std::experimental::pairing_heap_hook;
+
+struct node : pairing_heap_hook {
+    int key;
+    int id;
+};
+
+struct key_less {
+    bool operator()(const node& a, const node& b) const { return a.key < b.key; }
+};
+
+void basic_test()
+{
+    std::vector<node> nodes(6);
+    pairing_heap<node, key_less> h;
+    int keys[] = { 5, 3, 9, 1, 7, 3 };
+    for (int i = 0; i < 6; ++i) {
+        nodes[i].key = keys[i];
+        nodes[i].id = i;
+        h.push(nodes[i]);
+    }
+    assert(h.size() == 6);
+    assert(h.top().key == 1);
+
+    nodes[2].key = 0;  // 9 -> 0
+    h.decrease_key(nodes[2]);
+    assert(&h.top() == &nodes[2]);
+
+    h.erase(nodes[0]);  // the 5
+    h.erase(nodes[2]);  // the root
+    assert(h.size() == 4);
+    for (int k : { 1, 3, 3, 7 }) {
+        assert(h.top().key == k);
+        h.pop();
+    }
+    assert(h.empty());
+}
+
+void merge_test()
+{
+    std::vector<node> nodes(10);
+    pairing_heap<node, key_less> a, b;
+    for (int i = 0; i < 10; ++i) {
+        nodes[i].key = (i * 7) % 10;
+        ((i % 2) ? a : b).push(nodes[i]);
+    }
+    a.merge(b);
+    assert(b.empty());
+    assert(a.size() == 10);
+    a.merge(a);
+    assert(a.size() == 10);
+    for (int k = 0; k < 10; ++k) {
+        assert(a.top().key == k);
+        a.pop();
+    }
+}
+
+void dijkstra_test()
+{
+    // Shortest paths on a random graph, with decrease_key, checked against
+    // a lazy-deletion std::priority_queue version.
+    const int n = 2000;
+    std::mt19937 g(9);
+    std::vector<std::vector<std::pair<int, int>>> adj(n);
+    for (int i = 0; i < n * 8; ++i) {
+        adj[g() % n].emplace_back(int(g() % n), int(g() % 1000));
+    }
+
+    std::vector<int> expected(n, INT_MAX);
+    {
+        using item = std::pair<int, int>;
+        std::priority_queue<item, std::vector<item>, std::greater<>> pq;
+        expected[0] = 0;
+        pq.emplace(0, 0);
+        while (not pq.empty()) {
+            auto top = pq.top();
+            pq.pop();
+            if (top.first != expected[top.second]) {
+                continue;
+            }
+            for (auto&& e : adj[top.second]) {
+                if (top.first + e.second < expected[e.first]) {
+                    expected[e.first] = top.first + e.second;
+                    pq.emplace(expected[e.first], e.first);
+                }
+            }
+        }
+    }
+
+    std::vector<node> nodes(n);
+    std::vector<bool> queued(n, false);
+    pairing_heap<node, key_less> h;
+    for (int i = 0; i < n; ++i) {
+        nodes[i].key = INT_MAX;
+        nodes[i].id = i;
+    }
+    nodes[0].key = 0;
+    h.push(nodes[0]);
+    queued[0] = true;
+    while (not h.empty()) {
+        node& u = h.top();
+        h.pop();
+        queued[u.id] = false;
+        for (auto&& e : adj[u.id]) {
+            node& v = nodes[e.first];
+            if (u.key + e.second < v.key) {
+                v.key = u.key + e.second;
+                if (queued[v.id]) {
+                    h.decrease_key(v);
+                } else {
+                    h.push(v);
+                    queued[v.id] = true;
+                }
+            }
+        }
+    }
+    for (int i = 0; i < n; ++i) {
+        assert(nodes[i].key == expected[i]);
+    }
+}
+
+void timer_test()
+{
+    // Timers are armed, cancelled and fired at random.
+    std::vector<node> timers(500);
+    std::vector<bool> armed(timers.size(), false);
+    std::set<std::pair<int, int>> model;
+    pairing_heap<node, key_less> h;
+    std::mt19937 g(13);
+    int now = 0;
+    for (int step = 0; step < 20000; ++step) {
+        int i = int(g() % timers.size());
+        if (armed[i]) {
+            model.erase(std::make_pair(timers[i].key, i));
+            h.erase(timers[i]);
+            armed[i] = false;
+        } else {
+            timers[i].key = now + int(g() % 1000);
+            timers[i].id = i;
+            h.push(timers[i]);
+            model.emplace(timers[i].key, i);
+            armed[i] = true;
+        }
+        if (step % 3 == 0 && not h.empty()) {
+            assert(h.top().key == model.begin()->first);
+            now = h.top().key;
+            armed[h.top().id] = false;
+            model.erase(std::make_pair(h.top().key, h.top().id));
+            h.pop();
+        }
+        assert(h.size() == model.size());
+    }
+}
+
+int main()
+{
+    basic_test();
+    merge_test();
+    dijkstra_test();
+    timer_test();
+}
@@ -0,0 +1,82 @@
+#include "ring_algorithm.h"
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+using std::experimental::ring_span;
+using std::experimental::parallel_for_each;
+using std::experimental::parallel_reduce;
+using std::experimental::parallel_transform;
+
+// A ring of 0, 1, 2, ... n-1 whose front is two-thirds of the way into
+// the buffer, so that its contents wrap around the end.
+template<class T>
+ring_span<T> make_wrapped_ring(std::vector<T>& buffer, std::size_t n)
+{
+    ring_span<T> rs(buffer.begin(), buffer.end(), buffer.begin() + buffer.size() * 2 / 3, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        rs.push_back(T(i));
+    }
+    assert(rs.array_two().second != 0);
+    return rs;
+}
+
+void for_each_test()
+{
+    std::vector<std::int64_t> buffer(200000);
+    auto rs = make_wrapped_ring(buffer, 150000);
+    parallel_for_each(rs, [](std::int64_t& x) { x *= 2; }, 4);
+    std::int64_t i = 0;
+    for (auto&& x : rs) {
+        assert(x == 2 * i);
+        ++i;
+    }
+}
+
+void transform_test()
+{
+    std::vector<std::int64_t> buffer(200000);
+    auto rs = make_wrapped_ring(buffer, 199999);
+    std::vector<std::int64_t> out(rs.size());
+    auto end = parallel_transform(rs, out.begin(), [](std::int64_t x) { return x + 1; }, 3);
+    assert(end == out.end());
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        assert(out[i] == std::int64_t(i) + 1);
+    }
+}
+
+void reduce_test()
+{
+    std::vector<std::int64_t> buffer(200000);
+    auto rs = make_wrapped_ring(buffer, 100000);
+    std::int64_t sum = parallel_reduce(rs, std::int64_t(7), std::plus<>(), 5);
+    assert(sum == 7 + std::int64_t(100000) * 99999 / 2);
+
+    // Too small to split, but still wrapped.
+    std::vector<std::int64_t> small_buffer(10);
+    auto small = make_wrapped_ring(small_buffer, 5);
+    assert(parallel_reduce(small, std::int64_t(0), std::plus<>()) == 10);
+
+    // A non-commutative operation sees the elements in order.
+    std::vector<std::string> strings(70000);
+    ring_span<std::string> srs(strings.begin(), strings.end(), strings.begin() + 40000, 0);
+    for (int i = 0; i < 70000; ++i) {
+        srs.push_back(std::string(1, char('a' + i % 26)));
+    }
+    std::string joined = parallel_reduce(srs, std::string(">"), [](std::string a, const std::string& b) { return a + b; }, 4);
+    assert(joined.size() == 70001);
+    assert(joined[0] == '>');
+    for (int i = 0; i < 70000; ++i) {
+        assert(joined[i + 1] == char('a' + i % 26));
+    }
+}
+
+int main()
+{
+    for_each_test();
+    transform_test();
+    reduce_test();
+}
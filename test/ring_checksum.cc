@@ -0,0 +1,71 @@
+#include "ring_checksum.h"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using std::experimental::crc32c;
+using std::experimental::ring_span;
+
+void known_answer_test()
+{
+    const char *check = "123456789";
+    assert(crc32c().update(check, 9).value() == 0xE3069283u);
+    assert(crc32c().value() == 0);
+
+    // Feeding the same bytes in pieces gives the same answer.
+    crc32c h;
+    h.update(check, 2).update(check + 2, 5).update(check + 7, 2);
+    assert(h.value() == 0xE3069283u);
+}
+
+void segments_test()
+{
+    std::array<char, 4> buffer;
+    ring_span<char> rs(buffer.begin(), buffer.end(), buffer.begin(), 0);
+    rs.push_back('x');
+    rs.push_back('x');
+    rs.pop_front();
+    rs.pop_front();
+    rs.push_back('a');
+    rs.push_back('b');
+    rs.push_back('c');
+    // The buffer is now "c x a b"; the ring is "a b c".
+    assert(rs.array_one().first == &buffer[2] && rs.array_one().second == 2);
+    assert(rs.array_two().first == &buffer[0] && rs.array_two().second == 1);
+    assert(crc32c().update(rs).value() == crc32c().update("abc", 3).value());
+    assert(crc32c().update(rs, 1, 2).value() == crc32c().update("bc", 2).value());
+}
+
+void incremental_test()
+{
+    // Checksum each bulk append as it arrives, and compare against
+    // checksumming the whole history at once.
+    std::vector<std::uint32_t> buffer(1000);
+    ring_span<std::uint32_t> rs(buffer.begin(), buffer.end(), buffer.begin(), 0);
+    std::vector<std::uint32_t> history;
+    crc32c running;
+    std::uint32_t next = 0;
+    for (int batch = 0; batch < 40; ++batch) {
+        const std::size_t n = 37 + batch;
+        for (std::size_t i = 0; i < n; ++i) {
+            rs.push_back(next);
+            history.push_back(next);
+            ++next;
+        }
+        running.update(rs, rs.size() - n, n);
+        while (rs.size() > 500) {
+            rs.pop_front();
+        }
+    }
+    assert(running.value() == crc32c().update(history.data(), history.size() * sizeof(std::uint32_t)).value());
+}
+
+int main()
+{
+    known_answer_test();
+    segments_test();
+    incremental_test();
+}
@@ -0,0 +1,54 @@
+#include "sliding_hyperloglog.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+using std::experimental::sliding_hyperloglog;
+
+bool close_to(double estimate, double actual, double tolerance)
+{
+    return std::fabs(estimate - actual) <= tolerance * actual;
+}
+
+void accuracy_test()
+{
+    // 10 new users per tick for 10000 ticks, plus one user seen every tick.
+    sliding_hyperloglog<std::uint64_t> hll(12, 5000);
+    std::uint64_t next_user = 1;
+    for (std::uint64_t t = 0; t < 10000; ++t) {
+        for (int i = 0; i < 10; ++i) {
+            hll.insert(next_user++, t);
+        }
+        hll.insert(0, t);
+    }
+    const std::uint64_t now = 9999;
+    assert(close_to(hll.estimate(0, now), 11, 0.2));
+    assert(close_to(hll.estimate(99, now), 1001, 0.1));
+    assert(close_to(hll.estimate(999, now), 10001, 0.1));
+    assert(close_to(hll.estimate(4999, now), 50001, 0.1));
+}
+
+void repeats_test()
+{
+    // Re-inserting the same keys doesn't inflate the estimate,
+    // and keys age out of the window.
+    sliding_hyperloglog<int, std::hash<int>, unsigned> hll(10, 1000);
+    for (unsigned t = 0; t < 100; ++t) {
+        for (int k = 0; k < 500; ++k) {
+            hll.insert(k, t);
+        }
+    }
+    assert(close_to(hll.estimate(50, 99), 500, 0.1));
+    for (int k = 1000; k < 1100; ++k) {
+        hll.insert(k, 900);
+    }
+    assert(close_to(hll.estimate(100, 900), 100, 0.1));
+    assert(close_to(hll.estimate(1000, 900), 600, 0.1));
+}
+
+int main()
+{
+    accuracy_test();
+    repeats_test();
+}
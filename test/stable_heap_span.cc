@@ -0,0 +1,105 @@
+#include "stable_heap_span.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+
+using std::experimental::stable_heap_span;
+
+struct task {
+    int priority;
+    int id;
+};
+
+struct priority_of {
+    int operator()(const task& t) const { return t.priority; }
+};
+
+template<class Comparator, unsigned SequenceBits>
+void fifo_test(int n)
+{
+    using heap = stable_heap_span<task, priority_of, Comparator, SequenceBits>;
+    std::mt19937 g(n);
+    std::vector<task> input;
+    for (int i = 0; i < n; ++i) {
+        input.push_back(task{ int(g() % 7) - 3, i });
+    }
+    std::vector<task> expected = input;
+    std::stable_sort(expected.begin(), expected.end(), [](const task& a, const task& b) {
+        return Comparator()(a.priority, b.priority);
+    });
+
+    std::vector<typename heap::entry_type> buffer(n);
+    heap h(buffer.begin(), buffer.end());
+    for (auto&& t : input) {
+        h.push(t);
+    }
+    for (auto&& t : expected) {
+        assert(h.top().priority == t.priority);
+        assert(h.top().id == t.id);
+        h.pop();
+    }
+    assert(h.empty());
+}
+
+void renumber_test()
+{
+    // With 4 sequence bits, numbers run out every 16 pushes; interleave
+    // pushes and pops so renumbering happens with a non-empty heap.
+    using heap = stable_heap_span<task, priority_of, std::less<>, 4>;
+    std::vector<heap::entry_type> buffer(8);
+    heap h(buffer.begin(), buffer.end());
+    int next_id = 0;
+    std::vector<task> model;
+    for (int round = 0; round < 100; ++round) {
+        while (model.size() < 6) {
+            task t{ next_id % 3, next_id };
+            ++next_id;
+            h.push(t);
+            model.push_back(t);
+        }
+        std::stable_sort(model.begin(), model.end(), [](const task& a, const task& b) { return a.priority < b.priority; });
+        for (int i = 0; i < 3; ++i) {
+            assert(h.top().id == model.front().id);
+            h.pop();
+            model.erase(model.begin());
+        }
+    }
+}
+
+struct self {
+    template<class T> T operator()(T t) const { return t; }
+};
+
+void word_size_test()
+{
+    using small = stable_heap_span<std::int32_t, self>;
+    static_assert(sizeof(small::word_type) == 8, "a 32-bit key and 32-bit sequence fit in 64 bits");
+#if defined(__SIZEOF_INT128__)
+    using wide = stable_heap_span<std::int64_t, self, std::greater<>>;
+    static_assert(sizeof(wide::word_type) == 16, "a 64-bit key needs a 128-bit word");
+    std::vector<wide::entry_type> buffer(4);
+    wide h(buffer.begin(), buffer.end());
+    h.push(-5);
+    h.push(INT64_MIN);
+    h.push(INT64_MAX);
+    assert(h.top() == INT64_MAX); h.pop();
+    assert(h.top() == -5); h.pop();
+    assert(h.top() == INT64_MIN); h.pop();
+    assert(h.empty());
+#endif
+}
+
+int main()
+{
+    fifo_test<std::less<>, 32>(1000);
+    fifo_test<std::greater<>, 32>(1000);
+    fifo_test<std::less<>, 5>(31);
+    fifo_test<std::greater<int>, 6>(63);
+    renumber_test();
+    word_size_test();
+}
@@ -0,0 +1,106 @@
+#include "trivially_relocatable.h"
+#include "fixed_ring.h"
+#include "ring_span.h"
+
+#include <cassert>
+#include <memory>
+#include <string>
+#include <vector>
+
+using std::experimental::is_trivially_relocatable;
+using std::experimental::ring_span;
+namespace detail = std::experimental::detail;
+
+static_assert(is_trivially_relocatable<int>::value, "");
+static_assert(is_trivially_relocatable<std::unique_ptr<int>>::value, "");
+static_assert(is_trivially_relocatable<std::shared_ptr<int>>::value, "");
+static_assert(not is_trivially_relocatable<std::string>::value, "");
+static_assert(not is_trivially_relocatable<std::vector<int>>::value, "");
+
+template<class T, class Make>
+void rotate_test(Make make)
+{
+    for (int n : { 0, 1, 2, 7, 100 }) {
+        for (int mid = 0; mid <= n; mid += 1 + n / 5) {
+            std::vector<T> v;
+            for (int i = 0; i < n; ++i) {
+                v.push_back(make(i));
+            }
+            T *first = v.data();
+            T *result = detail::relocating_rotate(first, first + mid, first + n);
+            assert(result == first + (n - mid));
+            for (int i = 0; i < n; ++i) {
+                assert(*v[i] == *make((i + mid) % n));
+            }
+        }
+    }
+}
+
+template<class T, class Make>
+void swap_ranges_test(Make make)
+{
+    std::vector<T> a, b;
+    for (int i = 0; i < 300; ++i) {
+        a.push_back(make(i));
+        b.push_back(make(1000 + i));
+    }
+    detail::relocating_swap_ranges(a.data(), b.data(), a.size());
+    for (int i = 0; i < 300; ++i) {
+        assert(*a[i] == *make(1000 + i));
+        assert(*b[i] == *make(i));
+    }
+}
+
+void linearize_test()
+{
+    using ptr = std::unique_ptr<int>;
+    std::vector<ptr> buffer(5);
+    ring_span<ptr> r(buffer.begin(), buffer.end(), buffer.begin(), 0);
+    for (int i = 0; i < 8; ++i) {
+        r.push_back(std::make_unique<int>(i));
+    }
+    r.pop_front();
+    ptr *p = r.linearize();
+    assert(p == buffer.data());
+    assert(r.array_one().second == 4 && r.array_two().second == 0);
+    for (int i = 0; i < 4; ++i) {
+        assert(*p[i] == 4 + i);
+    }
+    assert(*r.front() == 4 && *r.back() == 7);
+    r.push_back(std::make_unique<int>(8));
+    assert(*r.back() == 8 && r.full());
+
+    std::vector<std::string> sbuffer(3);
+    ring_span<std::string> s(sbuffer.begin(), sbuffer.end(), sbuffer.begin(), 0);
+    for (const char *x : { "a", "b", "c", "d" }) {
+        s.push_back(x);
+    }
+    s.linearize();
+    assert(sbuffer[0] == "b" && sbuffer[1] == "c" && sbuffer[2] == "d");
+}
+
+void fixed_ring_swap_test()
+{
+    fixed_ring<std::unique_ptr<int>, 4> a, b;
+    for (int i = 0; i < 6; ++i) {
+        a.push(std::make_unique<int>(i));
+    }
+    b.push(std::make_unique<int>(42));
+    a.swap(b);
+    assert(a.size() == 1 && *a.front() == 42);
+    assert(b.size() == 4 && *b.front() == 2 && *b.back() == 5);
+}
+
+int main()
+{
+    auto make_unique = [](int i) { return std::make_unique<int>(i); };
+    auto make_shared = [](int i) { return std::make_shared<std::string>(std::to_string(i)); };
+    auto make_vector = [](int i) { return std::make_unique<std::vector<int>>(1, i); };
+    rotate_test<std::unique_ptr<int>>(make_unique);
+    rotate_test<std::shared_ptr<std::string>>(make_shared);
+    swap_ranges_test<std::unique_ptr<int>>(make_unique);
+    swap_ranges_test<std::shared_ptr<std::string>>(make_shared);
+    swap_ranges_test<std::unique_ptr<std::vector<int>>>(make_vector);
+    linearize_test();
+    fixed_ring_swap_test();
+}
@@ -0,0 +1,84 @@
+#include "window_aggregate.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <tuple>
+#include <vector>
+
+using std::experimental::window_aggregate;
+
+using result = std::tuple<unsigned, unsigned, int>;
+
+void tumbling_test()
+{
+    window_aggregate<int, std::plus<>, unsigned> agg(60, 60);
+    std::vector<result> results;
+    auto record = [&](unsigned start, unsigned end, int sum) { results.emplace_back(start, end, sum); };
+
+    agg.push(0, 1, record);
+    agg.push(30, 2, record);
+    agg.push(59, 3, record);
+    assert(results.empty());
+    agg.push(60, 10, record);
+    assert(results.size() == 1);
+    assert(results[0] == result(0, 60, 6));
+    agg.push(150, 100, record);
+    assert(results.size() == 2);
+    assert(results[1] == result(60, 120, 10));
+    agg.advance(180, record);
+    assert(results.size() == 3);
+    assert(results[2] == result(120, 180, 100));
+}
+
+void hopping_test()
+{
+    // 30-second windows every 10 seconds: each pane is 10 seconds wide.
+    window_aggregate<int, std::plus<>, unsigned> agg(30, 10);
+    assert(agg.pane() == 10);
+    std::vector<result> results;
+    auto record = [&](unsigned start, unsigned end, int sum) { results.emplace_back(start, end, sum); };
+
+    for (unsigned t = 0; t < 60; ++t) {
+        agg.push(t, 1, record);
+    }
+    agg.advance(60, record);
+    assert(results.size() == 6);
+    assert(results[0] == result(0, 10, 10));
+    assert(results[1] == result(0, 20, 20));
+    assert(results[2] == result(0, 30, 30));
+    assert(results[3] == result(10, 40, 30));
+    assert(results[4] == result(20, 50, 30));
+    assert(results[5] == result(30, 60, 30));
+}
+
+void max_test()
+{
+    // A 25-unit window sliding by 10 uses panes of width 5.
+    auto max = [](int a, int b) { return std::max(a, b); };
+    window_aggregate<int, decltype(max), unsigned> agg(25, 10, INT_MIN, max);
+    assert(agg.pane() == 5);
+    std::vector<result> results;
+    auto record = [&](unsigned start, unsigned end, int m) { results.emplace_back(start, end, m); };
+
+    agg.push(1, 7, record);
+    agg.push(12, 3, record);
+    agg.push(27, 5, record);
+    agg.advance(40, record);
+    assert(results.size() == 4);
+    assert(results[0] == result(0, 10, 7));
+    assert(results[1] == result(0, 20, 7));
+    assert(results[2] == result(5, 30, 5));
+    assert(results[3] == result(15, 40, 5));
+    agg.advance(60, record);
+    assert(results.size() == 6);
+    assert(results[4] == result(25, 50, 5));
+    assert(results[5] == result(35, 60, INT_MIN));
+}
+
+int main()
+{
+    tumbling_test();
+    hopping_test();
+    max_test();
+}
@@ -0,0 +1,70 @@
+#include "window_join.h"
+
+#include <cassert>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using std::experimental::window_join;
+
+using match = std::tuple<int, std::string, std::string>;
+
+void basic_test()
+{
+    window_join<int, std::string, std::string> j(5, 100, 100);
+    std::vector<match> matches;
+    auto record = [&](int k, const std::string& l, const std::string& r) {
+        matches.emplace_back(k, l, r);
+    };
+
+    j.push_left(0, 1, "order-a", record);
+    j.push_left(1, 2, "order-b", record);
+    assert(matches.empty());
+
+    j.push_right(3, 1, "fill-a1", record);
+    assert(matches.size() == 1);
+    assert(matches[0] == match(1, "order-a", "fill-a1"));
+
+    // Both order-a and order-b are still within the window.
+    j.push_right(5, 1, "fill-a2", record);
+    j.push_right(6, 2, "fill-b1", record);
+    assert(matches.size() == 3);
+    assert(matches[1] == match(1, "order-a", "fill-a2"));
+    assert(matches[2] == match(2, "order-b", "fill-b1"));
+
+    // order-a (t=0) has expired; the two fills for key 1 have not.
+    matches.clear();
+    j.push_right(6, 1, "fill-a3", record);
+    assert(matches.empty());
+    j.push_left(7, 1, "order-c", record);
+    assert(matches.size() == 3);
+    assert(matches[0] == match(1, "order-c", "fill-a1"));
+    assert(matches[1] == match(1, "order-c", "fill-a2"));
+    assert(matches[2] == match(1, "order-c", "fill-a3"));
+
+    j.advance(100);
+    assert(j.left_size() == 0);
+    assert(j.right_size() == 0);
+}
+
+void overflow_test()
+{
+    // Each side holds only 2 entries; older ones are forgotten.
+    window_join<int, int, int> j(1000, 2, 2);
+    int count = 0;
+    auto record = [&](int, int, int) { ++count; };
+    j.push_left(0, 7, 1, record);
+    j.push_left(1, 7, 2, record);
+    j.push_left(2, 8, 3, record);
+    assert(j.left_size() == 2);
+    j.push_right(3, 7, 0, record);
+    assert(count == 1);
+    j.push_right(3, 8, 0, record);
+    assert(count == 2);
+}
+
+int main()
+{
+    basic_test();
+    overflow_test();
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace std { namespace experimental {
+
+// A type is trivially relocatable if moving an object to a new address
+// and ending the lifetime of the old one amounts to copying its bytes.
+// In particular, the bytes of two live objects of such a type can be
+// exchanged to swap them.
+//
+// Every trivially copyable type qualifies. Others may opt in by
+// specializing this trait; the specializations below cover the standard
+// smart pointers, which hold no pointers into themselves. libstdc++'s
+// std::string does (its small-string buffer), so it must not opt in.
+//
+template<class T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template<class T>
+struct is_trivially_relocatable<std::unique_ptr<T>> : std::true_type {};
+
+template<class T>
+struct is_trivially_relocatable<std::unique_ptr<T[]>> : std::true_type {};
+
+template<class T>
+struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+
+template<class T>
+struct is_trivially_relocatable<std::weak_ptr<T>> : std::true_type {};
+
+namespace detail {
+
+template<class T>
+void relocating_swap_ranges(T *a, T *b, std::size_t n, std::false_type)
+{
+    std::swap_ranges(a, a + n, b);
+}
+
+template<class T>
+void relocating_swap_ranges(T *a, T *b, std::size_t n, std::true_type)
+{
+    unsigned char tmp[256];
+    unsigned char *pa = reinterpret_cast<unsigned char *>(static_cast<void *>(a));
+    unsigned char *pb = reinterpret_cast<unsigned char *>(static_cast<void *>(b));
+    for (std::size_t bytes = n * sizeof(T); bytes != 0; ) {
+        std::size_t k = (bytes < sizeof tmp) ? bytes : sizeof tmp;
+        std::memcpy(tmp, pa, k);
+        std::memcpy(pa, pb, k);
+        std::memcpy(pb, tmp, k);
+        pa += k;
+        pb += k;
+        bytes -= k;
+    }
+}
+
+template<class T>
+T *relocating_rotate(T *first, T *middle, T *last, std::false_type)
+{
+    return std::rotate(first, middle, last);
+}
+
+// Park the shorter side in a byte buffer and memmove the longer side over.
+template<class T>
+T *relocating_rotate(T *first, T *middle, T *last, std::true_type)
+{
+    const std::size_t left = middle - first;
+    const std::size_t right = last - middle;
+    if (left == 0) {
+        return last;
+    }
+    if (right == 0) {
+        return first;
+    }
+    void *vfirst = static_cast<void *>(first);
+    if (left <= right) {
+        std::unique_ptr<unsigned char[]> tmp(new unsigned char[left * sizeof(T)]);
+        std::memcpy(tmp.get(), vfirst, left * sizeof(T));
+        std::memmove(vfirst, static_cast<void *>(middle), right * sizeof(T));
+        std::memcpy(static_cast<void *>(first + right), tmp.get(), left * sizeof(T));
+    } else {
+        std::unique_ptr<unsigned char[]> tmp(new unsigned char[right * sizeof(T)]);
+        std::memcpy(tmp.get(), static_cast<void *>(middle), right * sizeof(T));
+        std::memmove(static_cast<void *>(first + right), vfirst, left * sizeof(T));
+        std::memcpy(vfirst, tmp.get(), right * sizeof(T));
+    }
+    return first + right;
+}
+
+// Swap the n elements at a with the n elements at b (which must not
+// overlap), bytewise if T is trivially relocatable.
+template<class T>
+void relocating_swap_ranges(T *a, T *b, std::size_t n)
+{
+    relocating_swap_ranges(a, b, n, is_trivially_relocatable<T>());
+}
+
+// As std::rotate, with memmove if T is trivially relocatable.
+template<class T>
+T *relocating_rotate(T *first, T *middle, T *last)
+{
+    return relocating_rotate(first, middle, last, is_trivially_relocatable<T>());
+}
+
+} // namespace detail
+
+} } // namespace std::experimental
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "ring_span.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace std { namespace experimental {
+
+// Tumbling (slide == size) and hopping (slide < size) window aggregation.
+//
+// Time is cut into panes of width gcd(size, slide). Each incoming value is
+// folded into the partial aggregate of the current pane exactly once; when
+// a pane closes, its partial is pushed into a ring holding the last
+// size/pane panes, and whenever a window boundary is crossed the window's
+// result is obtained by combining those partials. Values are never
+// re-scanned.
+//
+// Combine must be associative, and `identity` must be its identity element.
+// Windows are aligned to multiples of `slide`; results are reported as
+// on_window(window_start, window_end, aggregate) for the half-open
+// interval [window_start, window_end). Timestamps must be non-decreasing.
+//
+template<class T, class Combine = std::plus<>, class Time = std::uint64_t>
+class window_aggregate
+{
+public:
+    using value_type = T;
+    using time_type = Time;
+    using size_type = std::size_t;
+
+    window_aggregate(Time size, Time slide, T identity = T(), Combine combine = Combine()) :
+        size_(size),
+        slide_(slide),
+        pane_(gcd_(size, slide)),
+        identity_(identity),
+        combine_(std::move(combine)),
+        buffer_(size_type(size / pane_), identity),
+        panes_(buffer_.begin(), buffer_.end(), buffer_.begin(), 0),
+        partial_(identity),
+        pane_start_(),
+        started_(false)
+    {
+        assert(size != Time() && slide != Time() && slide <= size);
+    }
+
+    // panes_ views buffer_, and wouldn't follow it into a copy.
+    window_aggregate(const window_aggregate&) = delete;
+    window_aggregate& operator=(const window_aggregate&) = delete;
+
+    template<class F>
+    void push(const Time& t, const T& value, F&& on_window)
+    {
+        advance(t, on_window);
+        if (not started_) {
+            started_ = true;
+            pane_start_ = t - t % pane_;
+        }
+        partial_ = combine_(partial_, value);
+    }
+
+    // Close every pane that ends at or before t, reporting any windows
+    // that end along the way. The cost is proportional to the number of
+    // panes closed.
+    template<class F>
+    void advance(const Time& t, F&& on_window)
+    {
+        if (not started_) {
+            return;
+        }
+        while (t >= pane_start_ + pane_) {
+            close_pane_(on_window);
+        }
+    }
+
+    Time size() const noexcept { return size_; }
+    Time slide() const noexcept { return slide_; }
+    Time pane() const noexcept { return pane_; }
+
+private:
+    static Time gcd_(Time a, Time b)
+    {
+        while (b != Time()) {
+            Time r = a % b;
+            a = b;
+            b = r;
+        }
+        return a;
+    }
+
+    template<class F>
+    void close_pane_(F& on_window)
+    {
+        panes_.push_back(std::move(partial_));
+        partial_ = identity_;
+        pane_start_ += pane_;
+
+        const Time end = pane_start_;
+        if (end % slide_ == Time()) {
+            T result = identity_;
+            for (auto&& p : panes_) {
+                result = combine_(result, p);
+            }
+            on_window(end < size_ ? Time() : Time(end - size_), end, static_cast<const T&>(result));
+        }
+    }
+
+    Time size_;
+    Time slide_;
+    Time pane_;
+    T identity_;
+    Combine combine_;
+    std::vector<T> buffer_;
+    ring_span<T, null_popper<T>> panes_;
+    T partial_;
+    Time pane_start_;
+    bool started_;
+};
+
+} } // namespace std::experimental
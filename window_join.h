@@ -0,0 +1,191 @@
+#pragma once
+
+#include "ring_span.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace std { namespace experimental {
+
+namespace detail {
+
+// One side of a window_join: a time-ordered ring of entries, plus a hash
+// index from each key to the oldest and newest live entry with that key.
+// Entries with the same key are chained together through their sequence
+// numbers, so eviction from the front and probing by key are both
+// proportional only to the work actually done.
+//
+template<class Key, class Value, class Time, class Hash>
+class join_side
+{
+public:
+    using size_type = std::size_t;
+
+    static constexpr size_type npos = size_type(-1);
+
+    struct entry {
+        Time time;
+        Key key;
+        Value value;
+        size_type next;  // sequence number of the next entry with this key
+    };
+
+    explicit join_side(size_type capacity) :
+        buffer_(capacity),
+        ring_(buffer_.begin(), buffer_.end(), buffer_.begin(), 0),
+        front_seq_(0)
+    {
+        assert(capacity != 0);
+        index_.reserve(capacity);
+    }
+
+    // ring_ holds a pointer into buffer_, which a copy would share.
+    join_side(const join_side&) = delete;
+    join_side& operator=(const join_side&) = delete;
+
+    bool empty() const noexcept { return ring_.empty(); }
+    size_type size() const noexcept { return ring_.size(); }
+    size_type capacity() const noexcept { return ring_.capacity(); }
+
+    void evict_before(const Time& cutoff)
+    {
+        while (not ring_.empty() && ring_.front().time < cutoff) {
+            pop_front_();
+        }
+    }
+
+    void insert(const Time& t, const Key& k, Value v)
+    {
+        if (ring_.full()) {
+            // The window holds more entries than we have room for;
+            // the oldest entry is forgotten, just as with ring_span.
+            pop_front_();
+        }
+        const size_type seq = front_seq_ + ring_.size();
+        ring_.push_back(entry{t, k, std::move(v), npos});
+        auto result = index_.emplace(k, chain{seq, seq});
+        if (not result.second) {
+            entry_at_(result.first->second.newest).next = seq;
+            result.first->second.newest = seq;
+        }
+    }
+
+    template<class F>
+    void for_each_match(const Key& k, F&& f)
+    {
+        auto it = index_.find(k);
+        if (it == index_.end()) {
+            return;
+        }
+        for (size_type seq = it->second.oldest; seq != npos; ) {
+            entry& e = entry_at_(seq);
+            f(e.time, e.value);
+            seq = e.next;
+        }
+    }
+
+private:
+    struct chain {
+        size_type oldest;
+        size_type newest;
+    };
+
+    entry& entry_at_(size_type seq) noexcept
+    {
+        assert(seq - front_seq_ < ring_.size());
+        return detail::element_at(ring_, seq - front_seq_);
+    }
+
+    void pop_front_()
+    {
+        entry& e = ring_.front();
+        auto it = index_.find(e.key);
+        assert(it != index_.end() && it->second.oldest == front_seq_);
+        if (e.next == npos) {
+            index_.erase(it);
+        } else {
+            it->second.oldest = e.next;
+        }
+        ring_.pop_front();
+        ++front_seq_;
+    }
+
+    std::vector<entry> buffer_;
+    ring_span<entry, null_popper<entry>> ring_;
+    size_type front_seq_;
+    std::unordered_map<Key, chain, Hash> index_;
+};
+
+template<class Key, class Value, class Time, class Hash>
+constexpr typename join_side<Key, Value, Time, Hash>::size_type join_side<Key, Value, Time, Hash>::npos;
+
+} // namespace detail
+
+// A symmetric sliding-window equi-join of two event streams.
+// Each arrival evicts everything older than the window from both sides,
+// probes the opposite side's key index, and reports each match to the
+// caller as on_match(key, left_value, right_value). The cost per arrival
+// is O(1 + evictions + matches).
+//
+// Timestamps must be non-decreasing across all calls to push_left()
+// and push_right(). Each side remembers at most `capacity` entries;
+// size the rings for the peak arrival rate times the window.
+//
+template<class Key, class Left, class Right, class Time = std::uint64_t, class Hash = std::hash<Key>>
+class window_join
+{
+public:
+    using key_type = Key;
+    using left_type = Left;
+    using right_type = Right;
+    using time_type = Time;
+    using size_type = std::size_t;
+
+    window_join(Time window, size_type left_capacity, size_type right_capacity) :
+        window_(window),
+        left_(left_capacity),
+        right_(right_capacity)
+    {}
+
+    template<class F>
+    void push_left(const Time& t, const Key& k, Left v, F&& on_match)
+    {
+        evict_(t);
+        right_.for_each_match(k, [&](const Time&, const Right& r) { on_match(k, v, r); });
+        left_.insert(t, k, std::move(v));
+    }
+
+    template<class F>
+    void push_right(const Time& t, const Key& k, Right v, F&& on_match)
+    {
+        evict_(t);
+        left_.for_each_match(k, [&](const Time&, const Left& l) { on_match(k, l, v); });
+        right_.insert(t, k, std::move(v));
+    }
+
+    // Evict expired entries without a new arrival, e.g. on a watermark.
+    void advance(const Time& t) { evict_(t); }
+
+    Time window() const noexcept { return window_; }
+    size_type left_size() const noexcept { return left_.size(); }
+    size_type right_size() const noexcept { return right_.size(); }
+
+private:
+    void evict_(const Time& t)
+    {
+        const Time cutoff = (t < window_) ? Time() : Time(t - window_);
+        left_.evict_before(cutoff);
+        right_.evict_before(cutoff);
+    }
+
+    Time window_;
+    detail::join_side<Key, Left, Time, Hash> left_;
+    detail::join_side<Key, Right, Time, Hash> right_;
+};
+
+} } // namespace std::experimental